@@ -0,0 +1,716 @@
+/**
+ * @file config-json2-benchmark.cc
+ * @brief Synthetic topologies and per-stage ConfigJsonHelper::Install() benchmark.
+ *
+ * 为每个 (拓扑形状, 节点数) 生成一套完整的 json 配置（覆盖所有 JsonDomain），
+ * 在独立子进程中执行 Install()，收集 InstallProfiler 的分阶段 / 分 handler 耗时
+ * 和子进程峰值 RSS，并与基线比较：
+ *
+ *   ./ns3 run "config-json2-benchmark --sizes=1000,10000 --shapes=grid,star"
+ *   ./ns3 run "config-json2-benchmark --updateBaseline"     # 记录新基线
+ *
+ * 有阶段耗时或峰值内存超过基线 (1 + tolerance) 倍（且超过绝对噪声阈值）时返回 1。
+ * 生成的配置缓存在 outDir 中，加 --regenerate 重新生成。
+ * 只测安装，不运行仿真；路由表只保证每个节点有默认路由，并不完整。
+ */
+
+#include "ns3/config-json2-module.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+using ns3::configjson2::ConfigJsonHelper;
+using json = nlohmann::json;
+
+namespace
+{
+/* ===============================
+ * Streaming json writers
+ * =============================== */
+// 逐元素写出 json 数组，百万级元素时不在内存中保留整棵树
+class ArrayWriter
+{
+  public:
+    explicit ArrayWriter(const std::string& path)
+        : m_os(path)
+    {
+        NS_ABORT_MSG_IF(!m_os, "Cannot open " << path);
+        m_os << "[";
+    }
+
+    ~ArrayWriter()
+    {
+        m_os << "\n]\n";
+    }
+
+    void Add(const json& j)
+    {
+        m_os << (m_first ? "\n" : ",\n") << j.dump();
+        m_first = false;
+    }
+
+  private:
+    std::ofstream m_os;
+    bool m_first = true;
+};
+
+std::string
+Ipv4String(uint32_t a)
+{
+    return std::to_string(a >> 24) + "." + std::to_string((a >> 16) & 0xff) + "." +
+           std::to_string((a >> 8) & 0xff) + "." + std::to_string(a & 0xff);
+}
+
+json
+DeviceId(uint32_t nodeId, uint32_t linkId)
+{
+    return {{"nodeId", nodeId}, {"linkId", linkId}};
+}
+
+/* ===============================
+ * Synthetic configuration
+ * =============================== */
+/**
+ * 边生成边写盘：节点、链路、地址、移动模型和应用在添加时写出，
+ * 路由、协议栈和仿真参数在 Finish() 时写出。
+ * p2p 链路分配 /30，共享链路（wifi 小区）分配 /24；路由器之间的 p2p 链路同时分配 IPv6 /64。
+ */
+class SyntheticConfig
+{
+  public:
+    explicit SyntheticConfig(const std::string& dir)
+        : m_dir(dir),
+          m_nodes(dir + "/nodes.json"),
+          m_links(dir + "/links.json"),
+          m_ipv4(dir + "/ipv4-network.json"),
+          m_ipv6(dir + "/ipv6-network.json"),
+          m_mobility(dir + "/mobility.json"),
+          m_apps(dir + "/applications.json")
+    {
+    }
+
+    uint32_t AddNode(const std::string& role, double x, double y)
+    {
+        const uint32_t nodeId = m_uplink.size();
+        m_nodes.Add({{"nodeId", nodeId}, {"role", role}});
+        m_mobility.Add({{"nodeId", nodeId},
+                        {"type", "ConstantPositionMobilityModel"},
+                        {"position", {{"x", x}, {"y", y}, {"z", 0}}}});
+        m_uplink.push_back(Uplink{});
+        return nodeId;
+    }
+
+    // 移动站点：第 1 秒开始移向 (x + 20, y)
+    uint32_t AddMovingNode(const std::string& role, double x, double y)
+    {
+        const uint32_t nodeId = m_uplink.size();
+        m_nodes.Add({{"nodeId", nodeId}, {"role", role}});
+        m_mobility.Add({{"nodeId", nodeId},
+                        {"type", "WaypointMobilityModel"},
+                        {"position", {{"x", x}, {"y", y}, {"z", 0}}},
+                        {"waypoints",
+                         json::array({{{"time", 1}, {"x", x + 20}, {"y", y}, {"z", 0}}})}});
+        m_uplink.push_back(Uplink{});
+        return nodeId;
+    }
+
+    // a 为上游端（取 .1），b 取 .2；b 的默认路由经过 a
+    uint32_t AddP2p(uint32_t a, uint32_t b, const std::string& delay, bool ipv6)
+    {
+        const uint32_t linkId = m_linkCount++;
+        m_links.Add({{"linkId", linkId},
+                     {"type", "p2p"},
+                     {"netDevices", json::array({{{"nodeId", a}}, {{"nodeId", b}}})},
+                     {"device", {{"dataRate", "1Gbps"}, {"mtu", 1500}}},
+                     {"channel", {{"delay", delay}}},
+                     {"queue", {{"type", "ns3::DropTailQueue"}}}});
+
+        const uint32_t subnet = Allocate(4);
+        m_ipv4.Add({{"subnet", Ipv4String(subnet)},
+                    {"mask", "255.255.255.252"},
+                    {"base", "0.0.0.1"},
+                    {"netDeviceIds", json::array({DeviceId(a, linkId), DeviceId(b, linkId)})}});
+        if (ipv6)
+        {
+            char prefix[32];
+            std::snprintf(prefix,
+                          sizeof(prefix),
+                          "2001:db8:%x:%x::",
+                          m_ipv6Count >> 16,
+                          m_ipv6Count & 0xffff);
+            ++m_ipv6Count;
+            m_ipv6.Add({{"subnet", prefix},
+                        {"prefixLength", 64},
+                        {"netDeviceIds", json::array({DeviceId(a, linkId), DeviceId(b, linkId)})}});
+        }
+        SetUplink(b, linkId, subnet + 1);
+        return linkId;
+    }
+
+    // 一个 AP 加若干 STA，独立 Yans 信道；STA 的默认路由经过 AP
+    uint32_t AddWifiCell(uint32_t ap, const std::vector<uint32_t>& stas)
+    {
+        const uint32_t linkId = m_linkCount++;
+        const std::string ssid = "cell" + std::to_string(linkId);
+        const json phy = {{"channelSettings", "{36, 20, BAND_5GHZ, 0}"},
+                          {"txPowerStart", 20.0},
+                          {"txPowerEnd", 20.0}};
+
+        json devices = json::array();
+        json deviceIds = json::array();
+        devices.push_back({{"nodeId", ap},
+                           {"wifiPhy", phy},
+                           {"wifiMac", {{"type", "ns3::ApWifiMac"}, {"ssid", ssid}}}});
+        deviceIds.push_back(DeviceId(ap, linkId));
+        for (uint32_t sta : stas)
+        {
+            devices.push_back({{"nodeId", sta},
+                               {"wifiPhy", phy},
+                               {"wifiMac", {{"type", "ns3::StaWifiMac"}, {"ssid", ssid}}}});
+            deviceIds.push_back(DeviceId(sta, linkId));
+        }
+
+        const json loss = json::array({{{"type", "ns3::LogDistancePropagationLossModel"}}});
+        m_links.Add(
+            {{"linkId", linkId},
+             {"type", "wifi"},
+             {"netDevices", devices},
+             {"channel",
+              {{"type", "ns3::YansWifiChannel"},
+               {"propagationLoss", loss},
+               {"propagationDelay", "ns3::ConstantSpeedPropagationDelayModel"}}},
+             {"wifiStandard", "WIFI_STANDARD_80211a"},
+             {"errorRateModel", "ns3::YansErrorRateModel"},
+             {"wifiManager",
+              {{"type", "ns3::ConstantRateWifiManager"},
+               {"dataMode", "OfdmRate54Mbps"},
+               {"controlMode", "OfdmRate54Mbps"}}}});
+
+        const uint32_t subnet = Allocate(256);
+        m_ipv4.Add({{"subnet", Ipv4String(subnet)},
+                    {"mask", "255.255.255.0"},
+                    {"base", "0.0.0.1"},
+                    {"netDeviceIds", deviceIds}});
+        for (uint32_t sta : stas)
+            SetUplink(sta, linkId, subnet + 1);
+        return linkId;
+    }
+
+    // 在所有链路添加之后调用。偶数位主机装 PacketSink，奇数位装 OnOff 发往对侧的 sink，
+    // 每 16 个主机一对 UdpEcho 服务端 / 客户端
+    void AddApplications(const std::vector<uint32_t>& hosts)
+    {
+        const std::size_t n = hosts.size();
+        if (n < 2)
+            return;
+        const std::size_t sinks = (n + 1) / 2;
+        std::vector<uint32_t> appCount(n, 0);
+        auto add = [&](std::size_t k, json app) {
+            app["nodeId"] = hosts[k];
+            app["applicationId"] = appCount[k]++;
+            app["startTime"] = "1s";
+            app["stopTime"] = "9s";
+            m_apps.Add(app);
+        };
+        auto remote = [&](std::size_t k) {
+            return DeviceId(hosts[k], m_uplink[hosts[k]].linkId);
+        };
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            if (k % 2 == 0)
+            {
+                add(k,
+                    {{"type", "PacketSink"},
+                     {"socket", {{"type", "ipv4"}, {"port", 5000}}},
+                     {"protocol", "ns3::UdpSocketFactory"}});
+            }
+            else
+            {
+                const std::size_t dst = 2 * ((k / 2 + sinks / 2) % sinks);
+                add(k,
+                    {{"type", "OnOff"},
+                     {"socket", {{"type", "ipv4"}, {"netDeviceId", remote(dst)}, {"port", 5000}}},
+                     {"protocol", "ns3::UdpSocketFactory"},
+                     {"packetSize", 1024},
+                     {"dataRate", "100Kbps"}});
+            }
+
+            if (k % 16 == 3)
+            {
+                add(k, {{"type", "UdpEchoServer"}, {"socket", {{"type", "ipv4"}, {"port", 9}}}});
+            }
+            else if (k % 16 == 5)
+            {
+                add(k,
+                    {{"type", "UdpEchoClient"},
+                     {"socket", {{"type", "ipv4"}, {"netDeviceId", remote(k - 2)}, {"port", 9}}},
+                     {"maxPackets", 10},
+                     {"interval", "1s"},
+                     {"packetSize", 512}});
+            }
+        }
+    }
+
+    void Finish(const std::string& simName)
+    {
+        /* ---------- Routing ---------- */
+        {
+            ArrayWriter ipv4Routing(m_dir + "/ipv4-routing-protocol.json");
+            ArrayWriter ipv6Routing(m_dir + "/ipv6-routing-protocol.json");
+            for (uint32_t nodeId = 0; nodeId < m_uplink.size(); ++nodeId)
+            {
+                json routes = json::array();
+                if (m_uplink[nodeId].nextHop)
+                {
+                    routes.push_back({{"ipv4Address", "0.0.0.0"},
+                                      {"mask", "0.0.0.0"},
+                                      {"nextHop", Ipv4String(m_uplink[nodeId].nextHop)},
+                                      {"nextLinkId", m_uplink[nodeId].linkId}});
+                }
+                json jStatic = {{"type", "static"}, {"nodeId", nodeId}, {"priority", 10}};
+                ipv6Routing.Add({{"nodeId", nodeId}, {"ipv6RoutingList", json::array({jStatic})}});
+                jStatic["routes"] = std::move(routes);
+                ipv4Routing.Add({{"nodeId", nodeId}, {"ipv4RoutingList", json::array({jStatic})}});
+            }
+        }
+
+        const json jInternet = {{"enableGlobalRouting", false}};
+        std::ofstream(m_dir + "/internet-stack.json") << jInternet.dump(4);
+        std::ofstream(m_dir + "/simulator.json")
+            << json{{"simName", simName}, {"duration", "10s"}, {"seed", 1}, {"run", 1}}.dump(4);
+        const json jConfig = {{"nodes", "nodes.json"},
+                              {"links", "links.json"},
+                              {"internet", "internet-stack.json"},
+                              {"ipv4Network", "ipv4-network.json"},
+                              {"ipv6Network", "ipv6-network.json"},
+                              {"ipv4RoutingProtocol", "ipv4-routing-protocol.json"},
+                              {"ipv6RoutingProtocol", "ipv6-routing-protocol.json"},
+                              {"mobility", "mobility.json"},
+                              {"applications", "applications.json"},
+                              {"simulator", "simulator.json"}};
+        std::ofstream(m_dir + "/config.json") << jConfig.dump(4);
+    }
+
+    uint32_t GetNNodes() const
+    {
+        return m_uplink.size();
+    }
+
+  private:
+    struct Uplink
+    {
+        uint32_t linkId = 0;
+        uint32_t nextHop = 0;
+    };
+
+    // 按块大小对齐分配 IPv4 地址块，从 10.0.0.0 开始
+    uint32_t Allocate(uint32_t size)
+    {
+        m_nextAddress = (m_nextAddress + size - 1) / size * size;
+        const uint32_t subnet = m_nextAddress;
+        m_nextAddress += size;
+        return subnet;
+    }
+
+    void SetUplink(uint32_t nodeId, uint32_t linkId, uint32_t nextHop)
+    {
+        // 只记录第一条上行链路
+        if (!m_uplink[nodeId].nextHop)
+            m_uplink[nodeId] = Uplink{linkId, nextHop};
+    }
+
+    std::string m_dir;
+    ArrayWriter m_nodes;
+    ArrayWriter m_links;
+    ArrayWriter m_ipv4;
+    ArrayWriter m_ipv6;
+    ArrayWriter m_mobility;
+    ArrayWriter m_apps;
+    std::vector<Uplink> m_uplink;
+    uint32_t m_linkCount = 0;
+    uint32_t m_ipv6Count = 0;
+    uint32_t m_nextAddress = 10u << 24;
+};
+
+/* ===============================
+ * Shapes
+ * =============================== */
+// 两级星形：中心路由器 - sqrt(n) 个汇聚路由器 - 主机
+void
+GenerateStar(SyntheticConfig& cfg, uint32_t n)
+{
+    const uint32_t aggs = std::max<uint32_t>(1, std::ceil(std::sqrt(n)));
+    const uint32_t hub = cfg.AddNode("gateway", 0, 0);
+    std::vector<uint32_t> aggIds;
+    for (uint32_t i = 0; i < aggs && cfg.GetNNodes() < n; ++i)
+    {
+        const double angle = 2 * M_PI * i / aggs;
+        aggIds.push_back(cfg.AddNode("router", 100 * std::cos(angle), 100 * std::sin(angle)));
+        cfg.AddP2p(hub, aggIds.back(), "5ms", true);
+    }
+
+    std::vector<uint32_t> hosts;
+    for (uint32_t i = 0; cfg.GetNNodes() < n; ++i)
+    {
+        const uint32_t agg = aggIds[i % aggIds.size()];
+        hosts.push_back(cfg.AddNode("terminal", i % 1000, i / 1000));
+        cfg.AddP2p(agg, hosts.back(), "1ms", false);
+    }
+    cfg.AddApplications(hosts);
+}
+
+// k 叉胖树：(k/2)^2 核心、每个 pod k/2 汇聚 + k/2 接入、每个接入交换机 k/2 台主机；
+// 主机数截断使总节点数为 n
+void
+GenerateFatTree(SyntheticConfig& cfg, uint32_t n)
+{
+    uint32_t k = 4;
+    while (k * k * k / 4 + 5 * k * k / 4 < n)
+        k += 2;
+    const uint32_t half = k / 2;
+
+    std::vector<uint32_t> cores;
+    for (uint32_t i = 0; i < half * half; ++i)
+        cores.push_back(cfg.AddNode("router", 10.0 * i, 0));
+
+    std::vector<std::vector<uint32_t>> edges(k);
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        std::vector<uint32_t> aggs;
+        for (uint32_t j = 0; j < half; ++j)
+        {
+            aggs.push_back(cfg.AddNode("router", 100.0 * pod + 10 * j, 50));
+            for (uint32_t c = 0; c < half; ++c)
+                cfg.AddP2p(cores[j * half + c], aggs.back(), "10us", true);
+        }
+        for (uint32_t j = 0; j < half; ++j)
+        {
+            edges[pod].push_back(cfg.AddNode("router", 100.0 * pod + 10 * j, 100));
+            for (uint32_t agg : aggs)
+                cfg.AddP2p(agg, edges[pod].back(), "10us", true);
+        }
+    }
+
+    std::vector<uint32_t> hosts;
+    for (uint32_t h = 0; h < half && cfg.GetNNodes() < n; ++h)
+    {
+        for (uint32_t pod = 0; pod < k && cfg.GetNNodes() < n; ++pod)
+        {
+            for (uint32_t j = 0; j < half && cfg.GetNNodes() < n; ++j)
+            {
+                hosts.push_back(cfg.AddNode("terminal", 100.0 * pod + 10 * j + h, 150));
+                cfg.AddP2p(edges[pod][j], hosts.back(), "1us", false);
+            }
+        }
+    }
+    cfg.AddApplications(hosts);
+}
+
+// sqrt(n) x sqrt(n) 路由器网格，向右、向下各一条 p2p 链路；每个节点都是主机
+void
+GenerateGrid(SyntheticConfig& cfg, uint32_t n)
+{
+    const uint32_t side = std::max<uint32_t>(2, std::sqrt(n));
+    std::vector<uint32_t> hosts;
+    for (uint32_t r = 0; r < side; ++r)
+    {
+        for (uint32_t c = 0; c < side; ++c)
+            hosts.push_back(cfg.AddNode("router", 10.0 * c, 10.0 * r));
+    }
+    for (uint32_t r = 0; r < side; ++r)
+    {
+        for (uint32_t c = 0; c < side; ++c)
+        {
+            // 上游端在前：(0,0) 之外的节点都以左侧或上方邻居为默认网关
+            if (c + 1 < side)
+                cfg.AddP2p(hosts[r * side + c], hosts[r * side + c + 1], "1ms", true);
+            if (r + 1 < side)
+                cfg.AddP2p(hosts[r * side + c], hosts[(r + 1) * side + c], "1ms", true);
+        }
+    }
+    cfg.AddApplications(hosts);
+}
+
+// 每个小区 1 个 AP + 16 个 STA（其中 1 个移动）；每 64 个 AP 接一台汇聚路由器，汇聚路由器接中心
+void
+GenerateWifiCell(SyntheticConfig& cfg, uint32_t n)
+{
+    constexpr uint32_t kStas = 16;
+    constexpr uint32_t kApsPerAgg = 64;
+    const uint32_t cells = std::max<uint32_t>(1, n / (kStas + 1));
+    const uint32_t hub = cfg.AddNode("gateway", 0, 0);
+
+    std::vector<uint32_t> hosts;
+    uint32_t agg = 0;
+    for (uint32_t cell = 0; cell < cells && cfg.GetNNodes() < n; ++cell)
+    {
+        const double x = 200.0 * (cell % 256);
+        const double y = 200.0 * (cell / 256);
+        if (cell % kApsPerAgg == 0)
+        {
+            agg = cfg.AddNode("router", x, y - 50);
+            cfg.AddP2p(hub, agg, "5ms", true);
+        }
+        const uint32_t ap = cfg.AddNode("gateway", x, y);
+        cfg.AddP2p(agg, ap, "1ms", true);
+
+        std::vector<uint32_t> stas;
+        for (uint32_t s = 0; s < kStas && cfg.GetNNodes() < n; ++s)
+        {
+            const double angle = 2 * M_PI * s / kStas;
+            const double sx = x + 10 * std::cos(angle);
+            const double sy = y + 10 * std::sin(angle);
+            stas.push_back(s == 0 ? cfg.AddMovingNode("terminal", sx, sy)
+                                  : cfg.AddNode("terminal", sx, sy));
+        }
+        if (!stas.empty())
+            cfg.AddWifiCell(ap, stas);
+        hosts.insert(hosts.end(), stas.begin(), stas.end());
+    }
+    cfg.AddApplications(hosts);
+}
+
+void
+Generate(const std::string& shape, uint32_t n, const std::string& dir)
+{
+    SyntheticConfig cfg(dir);
+    if (shape == "star")
+        GenerateStar(cfg, n);
+    else if (shape == "fatTree")
+        GenerateFatTree(cfg, n);
+    else if (shape == "grid")
+        GenerateGrid(cfg, n);
+    else if (shape == "wifiCell")
+        GenerateWifiCell(cfg, n);
+    else
+        NS_ABORT_MSG("Unknown shape: " << shape);
+    cfg.Finish("bench-" + shape + "-" + std::to_string(n));
+}
+
+/* ===============================
+ * Measurement
+ * =============================== */
+std::vector<std::string>
+Split(const std::string& s)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        if (!item.empty())
+            out.push_back(item);
+    }
+    return out;
+}
+
+// 在子进程中安装，返回 InstallProfiler 报告并附加子进程峰值 RSS；失败时返回 null
+json
+MeasureInstall(const std::string& dir)
+{
+    const std::string profilePath = dir + "/install-profile.json";
+    std::remove(profilePath.c_str());
+    std::cout.flush();
+
+    // 每个用例一个新进程：Names / NodeList / Simulator 都是进程级单例，峰值 RSS 也互不干扰
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "fork failed");
+    if (pid == 0)
+    {
+        ConfigJsonHelper configHelper = ConfigJsonHelper::Default();
+        configHelper.profiler.Enable(profilePath, "json");
+        configHelper.Install(dir + "/config.json");
+        Simulator::Destroy();
+        std::fflush(nullptr);
+        _exit(0);
+    }
+
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return nullptr;
+
+    std::ifstream ifs(profilePath);
+    json report = json::parse(ifs);
+    report["peakRssBytes"] = static_cast<int64_t>(usage.ru_maxrss) * 1024;
+    return report;
+}
+
+// 超过基线 (1 + tolerance) 倍且差值超过噪声阈值时视为退化
+bool
+Regressed(double value, double baseline, double tolerance, double noise)
+{
+    return value > baseline * (1 + tolerance) && value - baseline > noise;
+}
+
+// 报告中各阶段及其 handler 的墙钟时间：键为 "阶段" 或 "阶段 / domain / type"
+std::map<std::string, double>
+TimedEntries(const json& report)
+{
+    std::map<std::string, double> entries;
+    for (const auto& s : report.at("stages"))
+    {
+        const std::string stage = s.at("name").get<std::string>();
+        entries["stage \"" + stage + "\""] = s.at("wallSec").get<double>();
+        for (const auto& h : s.at("handlers"))
+        {
+            entries["handler \"" + stage + " / " + h.at("domain").get<std::string>() + " / " +
+                    h.at("type").get<std::string>() + "\""] = h.at("wallSec").get<double>();
+        }
+    }
+    return entries;
+}
+
+uint32_t
+CompareWithBaseline(const json& results, const json& baseline, double tolerance)
+{
+    constexpr double kWallNoiseSec = 0.05;
+    constexpr double kRssNoiseBytes = 16 << 20;
+
+    uint32_t regressions = 0;
+    for (auto it = results.begin(); it != results.end(); ++it)
+    {
+        if (!baseline.contains(it.key()))
+        {
+            std::cout << it.key() << ": no baseline\n";
+            continue;
+        }
+        const json& base = baseline.at(it.key());
+        const json& cur = it.value();
+
+        // 阶段和 handler 用同一容差和噪声阈值；基线中有而本次没有的条目（改名或删除）也算退化，
+        // 确认后用 --updateBaseline 更新基线
+        const std::map<std::string, double> baseEntries = TimedEntries(base);
+        const std::map<std::string, double> curEntries = TimedEntries(cur);
+        for (const auto& [name, wall] : curEntries)
+        {
+            auto b = baseEntries.find(name);
+            if (b == baseEntries.end())
+            {
+                std::cout << it.key() << ": " << name << " not in baseline\n";
+                continue;
+            }
+            if (Regressed(wall, b->second, tolerance, kWallNoiseSec))
+            {
+                std::cout << it.key() << ": " << name << " " << b->second << "s -> " << wall
+                          << "s\n";
+                ++regressions;
+            }
+        }
+        for (const auto& [name, wall] : baseEntries)
+        {
+            if (!curEntries.count(name))
+            {
+                std::cout << it.key() << ": " << name << " missing (baseline " << wall << "s)\n";
+                ++regressions;
+            }
+        }
+
+        const double rss = cur.at("peakRssBytes").get<double>();
+        const double baseRss = base.at("peakRssBytes").get<double>();
+        if (Regressed(rss, baseRss, tolerance, kRssNoiseBytes))
+        {
+            std::cout << it.key() << ": peak RSS " << baseRss / (1 << 20) << " MiB -> "
+                      << rss / (1 << 20) << " MiB\n";
+            ++regressions;
+        }
+    }
+    return regressions;
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string shapes = "star,fatTree,grid,wifiCell";
+    std::string sizes = "1000,10000,100000,1000000";
+    std::string outDir = "config-json2-benchmark";
+    std::string baselinePath = "contrib/config-json2/examples/config-json2-benchmark-baseline.json";
+    std::string reportPath = "config-json2-benchmark.json";
+    double tolerance = 0.25;
+    bool regenerate = false;
+    bool updateBaseline = false;
+
+    CommandLine cmd;
+    cmd.AddValue("shapes", "Comma separated: star, fatTree, grid, wifiCell", shapes);
+    cmd.AddValue("sizes", "Comma separated node counts", sizes);
+    cmd.AddValue("outDir", "Directory for generated configurations", outDir);
+    cmd.AddValue("baseline", "Baseline report to compare against", baselinePath);
+    cmd.AddValue("report", "Where to write this run's report", reportPath);
+    cmd.AddValue("tolerance", "Allowed relative slowdown / memory growth", tolerance);
+    cmd.AddValue("regenerate", "Regenerate cached configurations", regenerate);
+    cmd.AddValue("updateBaseline", "Overwrite the baseline with this run", updateBaseline);
+    cmd.Parse(argc, argv);
+
+    mkdir(outDir.c_str(), 0755);
+
+    json results = json::object();
+    uint32_t failures = 0;
+    for (const auto& size : Split(sizes))
+    {
+        for (const auto& shape : Split(shapes))
+        {
+            const std::string name = shape + "-" + size;
+            const std::string dir = outDir + "/" + name;
+
+            // 1. 生成配置（不计时）
+            if (regenerate || !std::ifstream(dir + "/config.json"))
+            {
+                mkdir(dir.c_str(), 0755);
+                Generate(shape, std::stoul(size), dir);
+            }
+
+            // 2. 安装并记录
+            json report = MeasureInstall(dir);
+            if (report.is_null())
+            {
+                std::cout << name << ": install failed\n";
+                ++failures;
+                continue;
+            }
+            std::cout << name << ": " << report.at("wallSec").get<double>() << " s, peak RSS "
+                      << report.at("peakRssBytes").get<int64_t>() / (1 << 20) << " MiB\n";
+            for (const auto& s : report.at("stages"))
+            {
+                std::cout << "    " << s.at("name").get<std::string>() << ": "
+                          << s.at("wallSec").get<double>() << " s\n";
+            }
+            results[name] = std::move(report);
+        }
+    }
+
+    std::ofstream(reportPath) << results.dump(2);
+
+    // 3. 与基线比较
+    if (updateBaseline)
+    {
+        // 只覆盖本次运行的用例，保留其余用例的基线
+        json baseline = json::object();
+        if (std::ifstream ifs(baselinePath); ifs)
+            baseline = json::parse(ifs);
+        baseline.update(results);
+        std::ofstream(baselinePath) << baseline.dump(2);
+        std::cout << "baseline written to " << baselinePath << "\n";
+        return failures ? 1 : 0;
+    }
+
+    // 没有基线时无法判断退化，按失败处理，避免 CI 在缺少基线时静默通过
+    std::ifstream ifs(baselinePath);
+    if (!ifs)
+    {
+        std::cout << "no baseline at " << baselinePath << "; run with --updateBaseline\n";
+        return 1;
+    }
+    const uint32_t regressions = CompareWithBaseline(results, json::parse(ifs), tolerance);
+    std::cout << regressions << " regression(s)\n";
+    return failures || regressions ? 1 : 0;
+}
@@ -1,16 +1,43 @@
 #include "ns3/config-json2-module.h"
 
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
 using namespace ns3;
 using ns3::configjson2::ConfigJsonHelper;
 using ns3::configjson2::JsonDomain;
-using json = nlohmann::json;
+using ns3::configjson2::SweepRunner;
+using ns3::configjson2::json;
 int
 main(int argc, char* argv[])
 {
     CommandLine cmd;
     std::string configPath = "contrib/config-json2/examples/json-example/config.json";
+    std::string profilePath;
+    std::string subset;
+    bool mpi = false;
+    bool nullmsg = false;
     cmd.AddValue("config", "Path to config.json", configPath);
+    cmd.AddValue("profile", "Write an install profile report (.json or .csv)", profilePath);
+    cmd.AddValue("subset",
+                 "Install only a subset, as JSON (overrides \"subset\" in config.json)",
+                 subset);
+    cmd.AddValue("mpi", "Run distributed, one partition per MPI rank", mpi);
+    cmd.AddValue("nullmsg", "Use the null message synchronizer with --mpi", nullmsg);
     cmd.Parse(argc, argv);
+#ifdef NS3_MPI
+    // 0. 分布式：必须在创建任何节点之前启用
+    if (mpi)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(nullmsg ? "ns3::NullMessageSimulatorImpl"
+                                              : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+    }
+#else
+    NS_ABORT_MSG_IF(mpi, "--mpi requires ns-3 configured with --enable-mpi");
+#endif
     LogComponentEnable("ConfigJson2", LOG_LEVEL_DEBUG);
     // 1. 构建默认 ConfigJsonHelper
     ConfigJsonHelper configHelper = ConfigJsonHelper::Default();
@@ -18,10 +45,33 @@ main(int argc, char* argv[])
     configHelper.Register(JsonDomain::Mobility, "gazebo", [&configHelper](const json& j) {
         GazeboMobilityHandler(j, configHelper);
     });
-    // 3. 执行安装
-    configHelper.Install(configPath);
-    // 4. 启动仿真
+    if (!profilePath.empty())
+    {
+        configHelper.profiler.Enable(profilePath);
+    }
+    // 3. 读取并校验配置
+    configHelper.Load(configPath);
+    if (!subset.empty())
+    {
+        configHelper.handleJson[JsonDomain::Config]["subset"] = json::parse(subset);
+    }
+    // 参数扫描：每个 run 在 fork 出的子进程中安装并运行
+    if (configHelper.handleJson[JsonDomain::Config].contains("sweep"))
+    {
+        NS_ABORT_MSG_IF(mpi, "\"sweep\" cannot be combined with --mpi");
+        return SweepRunner(configHelper).Run() == 0 ? 0 : 1;
+    }
+    // 4. 执行安装
+    configHelper.Install();
+    // 5. 启动仿真（scheduler auto 时先预热选定调度器）
+    configHelper.WarmUpScheduler();
     Simulator::Run();
     Simulator::Destroy();
+#ifdef NS3_MPI
+    if (mpi)
+    {
+        MpiInterface::Disable();
+    }
+#endif
     return 0;
 }
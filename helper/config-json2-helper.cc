@@ -2,20 +2,213 @@
 
 #include "../model/config-json2-handler-default.h"
 
+#include <atomic>
+#include <exception>
+#include <glob.h>
+#include <regex>
+#include <thread>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 namespace ns3
 {
 namespace configjson2
 {
 NS_LOG_COMPONENT_DEFINE("ConfigJson2");
 
+namespace
+{
+// 全局路由或 nix-vector 路由作用于整个网络：不读路由文件，且每个 rank 需要完整拓扑
+bool
+UsesNetworkWideRouting(const json& jInternet)
+{
+    return jInternet.value("enableGlobalRouting", false) ||
+           jInternet.value("enableNixRouting", false);
+}
+
+// 估算一个 json 值及其子树占用的堆字节数（libstdc++ 容器布局，不含 malloc 自身开销）
+void
+JsonFootprint(const json& j, uint64_t& values, uint64_t& bytes)
+{
+    constexpr std::size_t kSso = 15;
+    constexpr std::size_t kMapNode = 32; // 红黑树节点头
+    auto stringBytes = [](const std::string& str) {
+        return str.capacity() > kSso ? str.capacity() + 1 : 0;
+    };
+
+    values++;
+    switch (j.type())
+    {
+    case json::value_t::object:
+        bytes += sizeof(json::object_t);
+        for (auto it = j.begin(); it != j.end(); ++it)
+        {
+            bytes += kMapNode + sizeof(std::string) + sizeof(json) + stringBytes(it.key());
+            JsonFootprint(it.value(), values, bytes);
+        }
+        break;
+    case json::value_t::array:
+        bytes += sizeof(json::array_t) +
+                 j.get_ref<const json::array_t&>().capacity() * sizeof(json);
+        for (const auto& e : j)
+            JsonFootprint(e, values, bytes);
+        break;
+    case json::value_t::string:
+        bytes += sizeof(json::string_t) + stringBytes(j.get_ref<const json::string_t&>());
+        break;
+    case json::value_t::binary:
+        bytes += sizeof(json::binary_t) + j.get_binary().capacity();
+        break;
+    default:
+        break;
+    }
+}
+
+// 一个 domain 的 JSON 占用：值个数、估算字节数和 arena 申请的字节数
+struct JsonCensus
+{
+    uint64_t values = 0;
+    uint64_t bytes = 0;
+    uint64_t arenaBytes = 0;
+};
+
+JsonCensus
+MeasureJson(const ConfigJsonHelper& helper, JsonDomain domain)
+{
+    JsonCensus census;
+    census.bytes = sizeof(json);
+    auto it = helper.handleJson.find(domain);
+    if (it != helper.handleJson.end())
+        JsonFootprint(it->second, census.values, census.bytes);
+    auto arenas = helper.jsonArenas.find(domain);
+    if (arenas != helper.jsonArenas.end())
+    {
+        for (const auto& arena : arenas->second)
+            census.arenaBytes += arena->ReservedBytes();
+    }
+    return census;
+}
+
+// Install 结束后统计各类对象个数和 JSON 占用，交给 profiler 输出。
+// held 为各 domain 释放前测得的占用，未释放的 domain 以结束时的占用计
+void
+RecordMemoryCensus(ConfigJsonHelper& helper, const std::map<JsonDomain, JsonCensus>& held)
+{
+    InstallProfiler& profiler = helper.profiler;
+
+    uint64_t devices = 0;
+    uint64_t routes = 0;
+    uint64_t applications = 0;
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<Node> node = *it;
+        profiler.AddObjectType(node->GetInstanceTypeId().GetName(), 1);
+        for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+            profiler.AddObjectType(node->GetDevice(i)->GetInstanceTypeId().GetName(), 1);
+        for (uint32_t i = 0; i < node->GetNApplications(); ++i)
+            profiler.AddObjectType(node->GetApplication(i)->GetInstanceTypeId().GetName(), 1);
+        devices += node->GetNDevices();
+        applications += node->GetNApplications();
+
+        if (Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>())
+        {
+            Ptr<Ipv4RoutingProtocol> proto = ipv4->GetRoutingProtocol();
+            if (auto r = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(proto))
+                routes += r->GetNRoutes();
+            if (auto r = Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting>(proto))
+                routes += r->GetNRoutes();
+        }
+        if (Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>())
+        {
+            Ptr<Ipv6RoutingProtocol> proto = ipv6->GetRoutingProtocol();
+            if (auto r = Ipv6RoutingHelper::GetRouting<Ipv6StaticRouting>(proto))
+                routes += r->GetNRoutes();
+        }
+    }
+
+    // 各阶段的堆增长按其主要创建的对象分摊
+    profiler.AddMemoryUnit("node",
+                           NodeList::GetNNodes(),
+                           {"Create Nodes", "Internet Stack", "Node Roles", "Mobility"});
+    profiler.AddMemoryUnit("device", devices, {"Install Links", "IPv4 / IPv6 Network"});
+    profiler.AddMemoryUnit("route", routes, {"IPv4 / IPv6 Routing"});
+    profiler.AddMemoryUnit("application", applications, {"Application"});
+
+    for (const auto& [domain, j] : helper.handleJson)
+    {
+        const JsonCensus retained = MeasureJson(helper, domain);
+        auto h = held.find(domain);
+        const JsonCensus& before = h != held.end() ? h->second : retained;
+        profiler.AddRetainedJson(DomainName(domain),
+                                 before.values,
+                                 before.bytes,
+                                 before.arenaBytes,
+                                 retained.values,
+                                 retained.bytes);
+    }
+}
+} // namespace
+
+const std::string&
+DomainName(JsonDomain domain)
+{
+    static const std::map<JsonDomain, std::string> names = {
+        {JsonDomain::Config, "Config"},
+        {JsonDomain::Node, "Node"},
+        {JsonDomain::Link, "Link"},
+        {JsonDomain::Internet, "Internet"},
+        {JsonDomain::Ipv4Network, "Ipv4Network"},
+        {JsonDomain::Ipv6Network, "Ipv6Network"},
+        {JsonDomain::Ipv4RoutingProtocol, "Ipv4RoutingProtocol"},
+        {JsonDomain::Ipv6RoutingProtocol, "Ipv6RoutingProtocol"},
+        {JsonDomain::Mobility, "Mobility"},
+        {JsonDomain::Application, "Application"},
+        {JsonDomain::Timeline, "Timeline"},
+        {JsonDomain::Simulator, "Simulator"},
+    };
+    return names.at(domain);
+}
+
+const std::vector<std::pair<std::string, JsonDomain>>&
+ConfigFileKeys()
+{
+    static const std::vector<std::pair<std::string, JsonDomain>> keys = {
+        {"nodes", JsonDomain::Node},
+        {"links", JsonDomain::Link},
+        {"internet", JsonDomain::Internet},
+        {"ipv4Network", JsonDomain::Ipv4Network},
+        {"ipv6Network", JsonDomain::Ipv6Network},
+        {"ipv4RoutingProtocol", JsonDomain::Ipv4RoutingProtocol},
+        {"ipv6RoutingProtocol", JsonDomain::Ipv6RoutingProtocol},
+        {"mobility", JsonDomain::Mobility},
+        {"applications", JsonDomain::Application},
+        {"timeline", JsonDomain::Timeline},
+        {"simulator", JsonDomain::Simulator},
+    };
+    return keys;
+}
+
 void
 ConfigJsonCore::Register(JsonDomain domain, std::string type, HandlerFn function)
 {
+    // 用普通 handler 覆盖两段式 handler 时不再走 decode / apply
+    auto it = m_splitRegistry.find(domain);
+    if (it != m_splitRegistry.end())
+        it->second.erase(type);
     m_registry[domain][type] = function;
 }
 
 HandlerFn
 ConfigJsonCore::GetRegistry(JsonDomain domain, const std::string& type) const
+{
+    const HandlerFn* fn = FindHandler(domain, type);
+    return fn ? *fn : nullptr;
+}
+
+const HandlerFn*
+ConfigJsonCore::FindHandler(JsonDomain domain, const std::string& type) const
 {
     auto itDomain = m_registry.find(domain);
     if (itDomain == m_registry.end())
@@ -29,7 +222,17 @@ ConfigJsonCore::GetRegistry(JsonDomain domain, const std::string& type) const
         return nullptr;
     }
 
-    return itHandler->second;
+    return &itHandler->second;
+}
+
+const SplitHandlerFn*
+ConfigJsonCore::FindSplitHandler(JsonDomain domain, const std::string& type) const
+{
+    auto itDomain = m_splitRegistry.find(domain);
+    if (itDomain == m_splitRegistry.end())
+        return nullptr;
+    auto itHandler = itDomain->second.find(type);
+    return itHandler == itDomain->second.end() ? nullptr : &itHandler->second;
 }
 
 ConfigJsonHelper
@@ -88,30 +291,55 @@ ConfigJsonHelper::Default()
     configHelper.Register(JsonDomain::Ipv4RoutingProtocol, "olsr", [&configHelper](const json& j) {
         OlsrHandler(j, configHelper);
     });
+    configHelper.Register(JsonDomain::Ipv4RoutingProtocol, "nix", [&configHelper](const json& j) {
+        Ipv4NixHandler(j, configHelper);
+    });
+    configHelper.Register(JsonDomain::Ipv6RoutingProtocol, "nix", [&configHelper](const json& j) {
+        Ipv6NixHandler(j, configHelper);
+    });
 
     /* ---------- Mobility ---------- */
-    configHelper.Register(
+    configHelper.RegisterSplit<MobilityConfig>(
         JsonDomain::Mobility,
         "ConstantPositionMobilityModel",
-        [&configHelper](const json& j) { ConstantPositionMobilityHandler(j, configHelper); });
-    configHelper.Register(
+        DecodeMobility,
+        [&configHelper](const MobilityConfig& c) {
+            ApplyConstantPositionMobility(c, configHelper);
+        });
+    configHelper.RegisterSplit<MobilityConfig>(
         JsonDomain::Mobility,
         "WaypointMobilityModel",
-        [&configHelper](const json& j) { WaypointMobilityHandler(j, configHelper); });
+        DecodeMobility,
+        [&configHelper](const MobilityConfig& c) { ApplyWaypointMobility(c, configHelper); });
 
     /* ---------- Application ---------- */
-    configHelper.Register(JsonDomain::Application, "UdpEchoClient", [&configHelper](const json& j) {
-        UdpEchoClientHandler(j, configHelper);
-    });
-    configHelper.Register(JsonDomain::Application, "UdpEchoServer", [&configHelper](const json& j) {
-        UdpEchoServerHandler(j, configHelper);
-    });
-    configHelper.Register(JsonDomain::Application, "OnOff", [&configHelper](const json& j) {
-        OnOffHandler(j, configHelper);
-    });
-    configHelper.Register(JsonDomain::Application, "PacketSink", [&configHelper](const json& j) {
-        PacketSinkHandler(j, configHelper);
-    });
+    configHelper.RegisterSplit<ApplicationConfig>(
+        JsonDomain::Application,
+        "UdpEchoClient",
+        DecodeApplication,
+        [&configHelper](const ApplicationConfig& c) { ApplyUdpEchoClient(c, configHelper); });
+    configHelper.RegisterSplit<ApplicationConfig>(
+        JsonDomain::Application,
+        "UdpEchoServer",
+        DecodeApplication,
+        [&configHelper](const ApplicationConfig& c) { ApplyUdpEchoServer(c, configHelper); });
+    configHelper.RegisterSplit<ApplicationConfig>(
+        JsonDomain::Application,
+        "OnOff",
+        DecodeApplication,
+        [&configHelper](const ApplicationConfig& c) { ApplyOnOff(c, configHelper); });
+    configHelper.RegisterSplit<ApplicationConfig>(
+        JsonDomain::Application,
+        "PacketSink",
+        DecodeApplication,
+        [&configHelper](const ApplicationConfig& c) { ApplyPacketSink(c, configHelper); });
+
+    /* ---------- Timeline ---------- */
+    configHelper.RegisterSplit<TimelineConfig>(
+        JsonDomain::Timeline,
+        "default",
+        DecodeTimeline,
+        [&configHelper](const TimelineConfig& c) { ApplyTimeline(c, configHelper); });
 
     /* ---------- Simulator ---------- */
     configHelper.Register(JsonDomain::Simulator, "default", [&configHelper](const json& j) {
@@ -120,21 +348,366 @@ ConfigJsonHelper::Default()
     return configHelper;
 }
 
+void
+ConfigJsonHelper::Invoke(JsonDomain domain, const std::string& type, const json& j)
+{
+    Invoke(domain, Prepare(domain, type, j));
+}
+
+InstallItem
+ConfigJsonHelper::Prepare(JsonDomain domain,
+                          const std::string& type,
+                          const json& j,
+                          uint32_t id) const
+{
+    const HandlerFn* fn = FindHandler(domain, type);
+    if (!fn)
+    {
+        throw std::invalid_argument("No handler registered for " + DomainName(domain) +
+                                    " type: " + type);
+    }
+    return {&j, fn, &type, id, FindSplitHandler(domain, type), nullptr};
+}
+
+void
+ConfigJsonHelper::Decode(InstallItem& item)
+{
+    if (item.split && !item.decoded)
+        item.decoded = item.split->decode(*item.j);
+}
+
+void
+ConfigJsonHelper::Invoke(JsonDomain domain, const InstallItem& item)
+{
+    auto call = [&item] {
+        if (!item.split)
+            (*item.fn)(*item.j);
+        else if (item.decoded)
+            item.split->apply(item.decoded.get());
+        else
+            item.split->apply(item.split->decode(*item.j).get());
+    };
+    if (!profiler.IsEnabled())
+    {
+        call();
+        return;
+    }
+    InstallProfiler::Scope scope(profiler, DomainName(domain), *item.type);
+    call();
+}
+
+uint32_t
+ConfigJsonHelper::GetSystemId(uint32_t nodeId) const
+{
+    return partition ? partition->GetSystemId(nodeId) : 0;
+}
+
+bool
+ConfigJsonHelper::IsNodeSelected(uint32_t nodeId) const
+{
+    return !subset || subset->ContainsNode(nodeId);
+}
+
+bool
+ConfigJsonHelper::IsNodeOwned(uint32_t nodeId) const
+{
+    return IsNodeSelected(nodeId) && (!partition || partition->IsNodeOwned(nodeId));
+}
+
+bool
+ConfigJsonHelper::IsNodeInstalled(uint32_t nodeId) const
+{
+    return IsNodeSelected(nodeId) && (!partition || partition->IsNodeInstalled(nodeId));
+}
+
+bool
+ConfigJsonHelper::IsLinkInstalled(uint32_t linkId) const
+{
+    return (!subset || subset->ContainsLink(linkId)) &&
+           (!partition || partition->IsLinkInstalled(linkId));
+}
+
+bool
+ConfigJsonHelper::IsDeviceInstalled(uint32_t nodeId, uint32_t linkId) const
+{
+    return IsNodeInstalled(nodeId) && IsLinkInstalled(linkId) &&
+           !(segments && segments->IsCollapsed(nodeId));
+}
+
+std::string
+ConfigJsonHelper::OutputPath(const std::string& path) const
+{
+    std::string tag = outputTag;
+    if (partition)
+        tag += "-rank" + std::to_string(partition->GetRank());
+    if (tag.empty())
+        return path;
+
+    // 在扩展名前插入
+    std::size_t slash = path.find_last_of('/');
+    std::size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + tag;
+    return path.substr(0, dot) + tag + path.substr(dot);
+}
+
 json
 ConfigJsonHelper::LoadJson(boost::filesystem::path path)
 {
-    std::ifstream ifs(path.string());
+    std::ifstream ifs(path.string(), std::ios::binary);
     if (!ifs.is_open())
     {
         throw std::runtime_error("ConfigJsonHelper: cannot open config file: " + path.string());
     }
-    json j;
-    ifs >> j;
-    return j;
+    // 整个文件读入内存后解析，比从流逐字符解析快
+    std::string text{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    return json::parse(text);
+}
+
+std::vector<boost::filesystem::path>
+ConfigJsonHelper::ExpandShards(const boost::filesystem::path& baseDir, const json& spec)
+{
+    std::vector<boost::filesystem::path> paths;
+    auto expand = [&](const std::string& pattern) {
+        // 序号区间：apps-000..127.json，位数取起始序号的位数
+        static const std::regex range(R"(^(.*?)(\d+)\.\.(\d+)(.*)$)");
+        std::smatch m;
+        if (std::regex_match(pattern, m, range))
+        {
+            const uint64_t first = std::stoull(m[2].str());
+            const uint64_t last = std::stoull(m[3].str());
+            if (first > last)
+                throw std::invalid_argument("Empty shard range: " + pattern);
+            const std::size_t width = m[2].length();
+            for (uint64_t i = first; i <= last; ++i)
+            {
+                std::string index = std::to_string(i);
+                if (index.size() < width)
+                    index.insert(0, width - index.size(), '0');
+                paths.push_back(baseDir / (m[1].str() + index + m[4].str()));
+            }
+            return;
+        }
+        if (pattern.find_first_of("*?[") == std::string::npos)
+        {
+            paths.push_back(baseDir / pattern);
+            return;
+        }
+        // glob 按路径名排序返回
+        glob_t matches;
+        const std::string full = (baseDir / pattern).string();
+        const int rc = glob(full.c_str(), 0, nullptr, &matches);
+        if (rc != 0)
+        {
+            globfree(&matches);
+            throw std::invalid_argument("No file matches: " + full);
+        }
+        for (std::size_t i = 0; i < matches.gl_pathc; ++i)
+            paths.emplace_back(matches.gl_pathv[i]);
+        globfree(&matches);
+    };
+
+    if (spec.is_array())
+    {
+        for (const auto& j : spec)
+            expand(j.get<std::string>());
+    }
+    else
+        expand(spec.get<std::string>());
+    return paths;
+}
+
+void
+ConfigJsonHelper::LoadDomain(JsonDomain domain, const boost::filesystem::path& path)
+{
+    LoadDomain(domain, std::vector<boost::filesystem::path>{path});
+}
+
+void
+ConfigJsonHelper::LoadDomain(JsonDomain domain, const std::vector<boost::filesystem::path>& paths)
+{
+    if (paths.empty())
+        throw std::invalid_argument("No file given for " + DomainName(domain));
+
+    // 每个分片解析到自己的 arena，分片之间互不共享状态，可以并行
+    const std::size_t n = paths.size();
+    std::vector<std::shared_ptr<JsonArena>> arenas(n);
+    std::vector<json> shards(n);
+    std::vector<std::exception_ptr> errors(n);
+    std::atomic<std::size_t> next{0};
+    auto parse = [&] {
+        for (std::size_t i = next++; i < n; i = next++)
+        {
+            try
+            {
+                arenas[i] = std::make_shared<JsonArena>();
+                JsonArena::Scope scope(arenas[i].get());
+                shards[i] = LoadJson(paths[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    const std::size_t threads = std::min<std::size_t>(installThreads, n - 1);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t)
+        workers.emplace_back(parse);
+    parse();
+    for (auto& w : workers)
+        w.join();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!errors[i])
+            continue;
+        try
+        {
+            std::rethrow_exception(errors[i]);
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error(paths[i].string() + ": " + e.what());
+        }
+    }
+
+    // 按分片顺序合并：数组依次拼接，对象合并且键不得重复；元素只移动，仍在各自的 arena 中
+    json j = std::move(shards[0]);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        if (j.is_array() && shards[i].is_array())
+        {
+            auto& out = j.get_ref<json::array_t&>();
+            auto& in = shards[i].get_ref<json::array_t&>();
+            out.reserve(out.size() + in.size());
+            std::move(in.begin(), in.end(), std::back_inserter(out));
+        }
+        else if (j.is_object() && shards[i].is_object())
+        {
+            for (auto& [key, value] : shards[i].items())
+            {
+                if (j.contains(key))
+                {
+                    throw std::invalid_argument(paths[i].string() + ": duplicate key '" + key +
+                                                "' in " + DomainName(domain) + " shards");
+                }
+                j[key] = std::move(value);
+            }
+        }
+        else
+        {
+            throw std::invalid_argument(paths[i].string() + ": " + DomainName(domain) +
+                                        " shards must all be arrays or all be objects");
+        }
+        shards[i] = json();
+    }
+
+    // 先替换 DOM 再替换 arena，旧 DOM 可能还在旧 arena 中
+    handleJson[domain] = std::move(j);
+    jsonArenas[domain] = std::move(arenas);
+}
+
+void
+ConfigJsonHelper::ReleaseJson(JsonDomain domain)
+{
+    auto it = handleJson.find(domain);
+    if (it != handleJson.end())
+        it->second = json();
+    jsonArenas.erase(domain);
+#ifdef __GLIBC__
+    // 归还 brk 堆顶和空闲页，仿真期间的分配不必与已释放的 DOM 碎片混在一起
+    malloc_trim(0);
+#endif
+}
+
+void
+ConfigJsonHelper::Validate() const
+{
+    std::vector<std::string> errors;
+    auto domainJson = [this](JsonDomain domain) -> const json& {
+        static const json empty = json::array();
+        auto it = handleJson.find(domain);
+        return it == handleJson.end() ? empty : it->second;
+    };
+    auto check = [&](JsonDomain domain, const std::string& where, const std::string& type) {
+        if (!GetRegistry(domain, type))
+        {
+            errors.push_back(where + ": no handler registered for " + DomainName(domain) +
+                             " type '" + type + "'");
+        }
+    };
+    // 逐元素检查，收集全部错误后一起报告
+    auto each = [&](JsonDomain domain, const std::function<void(const json&)>& fn) {
+        std::size_t i = 0;
+        for (const auto& j : domainJson(domain))
+        {
+            try
+            {
+                fn(j);
+            }
+            catch (const std::exception& e)
+            {
+                errors.push_back(DomainName(domain) + "[" + std::to_string(i) + "]: " + e.what());
+            }
+            ++i;
+        }
+    };
+
+    each(JsonDomain::Node, [&](const json& j) {
+        const std::string where = "node" + std::to_string(j.at("nodeId").get<uint32_t>());
+        if (j.contains("role"))
+            check(JsonDomain::Node, where, j.at("role").get<std::string>());
+    });
+    each(JsonDomain::Link, [&](const json& j) {
+        const std::string where = "link" + std::to_string(j.at("linkId").get<uint32_t>());
+        check(JsonDomain::Link, where, j.at("type").get<std::string>());
+        for (const auto& dev : j.at("netDevices"))
+            dev.at("nodeId").get<uint32_t>();
+    });
+    // 全局 / nix 路由时不会调用路由 handler，与 Install 保持一致
+    auto itInternet = handleJson.find(JsonDomain::Internet);
+    if (itInternet == handleJson.end() || !UsesNetworkWideRouting(itInternet->second))
+    {
+        const std::pair<JsonDomain, const char*> routing[] = {
+            {JsonDomain::Ipv4RoutingProtocol, "ipv4RoutingList"},
+            {JsonDomain::Ipv6RoutingProtocol, "ipv6RoutingList"},
+        };
+        for (auto [domain, list] : routing)
+        {
+            each(domain, [&, domain = domain, list = list](const json& j) {
+                const std::string where = "node" + std::to_string(j.at("nodeId").get<uint32_t>());
+                for (const auto& jRouting : j.at(list))
+                    check(domain, where, jRouting.at("type").get<std::string>());
+            });
+        }
+    }
+    each(JsonDomain::Mobility, [&](const json& j) {
+        const std::string where = "node" + std::to_string(j.at("nodeId").get<uint32_t>());
+        check(JsonDomain::Mobility, where, j.at("type").get<std::string>());
+    });
+    each(JsonDomain::Application, [&](const json& j) {
+        const std::string where = "node" + std::to_string(j.at("nodeId").get<uint32_t>());
+        check(JsonDomain::Application, where, j.at("type").get<std::string>());
+    });
+
+    if (!errors.empty())
+    {
+        std::string message = std::to_string(errors.size()) + " configuration error(s):";
+        for (const auto& e : errors)
+            message += "\n  " + e;
+        throw std::invalid_argument(message);
+    }
 }
 
 void
 ConfigJsonHelper::Install(boost::filesystem::path jsonPath)
+{
+    Load(jsonPath);
+    Install();
+}
+
+void
+ConfigJsonHelper::Load(boost::filesystem::path jsonPath)
 {
     try
     {
@@ -142,141 +715,457 @@ ConfigJsonHelper::Install(boost::filesystem::path jsonPath)
          * 0. Load Json File
          * =============================== */
         NS_LOG_DEBUG("[0%] Install Stage 0/10: Loading Json File");
+        profiler.BeginStage("Load Json File");
         status = JsonDomain::Config;
         configPath = jsonPath;
-        handleJson[JsonDomain::Config] = LoadJson(configPath);
-        m_registry.at(JsonDomain::Config).at("default")(handleJson[JsonDomain::Config]);
+        LoadDomain(JsonDomain::Config, configPath);
+        Invoke(JsonDomain::Config, "default", handleJson[JsonDomain::Config]);
+        Validate();
+        profiler.EndStage();
+    }
+    catch (const std::exception& e)
+    {
+        NS_FATAL_ERROR("ConfigJson Load failed: " << e.what());
+    }
+}
+
+void
+ConfigJsonHelper::Install()
+{
+    try
+    {
+        // "subset" 只安装选中的节点及只连接它们的链路，与 MPI 划分叠加
+        const json& jConfig = handleJson[JsonDomain::Config];
+        if (jConfig.contains("subset"))
+        {
+            subset = std::make_unique<TopologySubset>(jConfig.at("subset"),
+                                                      handleJson[JsonDomain::Node],
+                                                      handleJson[JsonDomain::Link]);
+            NS_LOG_INFO("subset: " << subset->GetNNodes() << " nodes, " << subset->GetNLinks()
+                                   << " links");
+        }
+        // MPI 启用且多于一个进程时划分拓扑，全局 / nix 路由需要每个 rank 都有完整拓扑
+        partition =
+            CreateMpiPartition(handleJson[JsonDomain::Config],
+                               handleJson[JsonDomain::Node],
+                               handleJson[JsonDomain::Link],
+                               UsesNetworkWideRouting(handleJson[JsonDomain::Internet]));
+        // 交换段合并要求段内链路都在本进程安装，须在子集和划分之后计算
+        if (jConfig.value("collapseSwitches", false))
+        {
+            segments = std::make_unique<SwitchedSegments>(
+                handleJson[JsonDomain::Node],
+                handleJson[JsonDomain::Link],
+                [this](uint32_t linkId) { return IsLinkInstalled(linkId); });
+            NS_LOG_INFO("collapseSwitches: " << segments->GetNSegments() << " segments");
+        }
+        ConfigureRng(handleJson[JsonDomain::Simulator]);
+        ConfigureSimulatorImplementation(handleJson[JsonDomain::Simulator], *this);
+
+        // prepare 在工作线程上只读各 domain 的 json，先在这里补齐缺省的条目
+        for (const auto& [key, domain] : ConfigFileKeys())
+            handleJson[domain];
+        const json& jNodes = handleJson.at(JsonDomain::Node);
+        const json& jLinks = handleJson.at(JsonDomain::Link);
+        const json& jInternet = handleJson.at(JsonDomain::Internet);
+        const json& jIpv4Networks = handleJson.at(JsonDomain::Ipv4Network);
+        const json& jIpv6Networks = handleJson.at(JsonDomain::Ipv6Network);
+        const json& jIpv4Routing = handleJson.at(JsonDomain::Ipv4RoutingProtocol);
+        const json& jIpv6Routing = handleJson.at(JsonDomain::Ipv6RoutingProtocol);
+        const json& jMobility = handleJson.at(JsonDomain::Mobility);
+        const json& jApplications = handleJson.at(JsonDomain::Application);
+        const json& jTimeline = handleJson.at(JsonDomain::Timeline);
+        const json& jSimulator = handleJson.at(JsonDomain::Simulator);
+
+        static const std::string kDefault = "default";
+        auto typeOf = [](const json& j, const char* key) -> const std::string& {
+            return j.at(key).get_ref<const std::string&>();
+        };
+        // 调用后即释放 decode 结果
+        auto invokeAll = [this](JsonDomain domain, std::vector<InstallItem>& items) {
+            for (auto& item : items)
+            {
+                currentNodeId = item.id;
+                Invoke(domain, item);
+                item.decoded.reset();
+            }
+        };
+
+        StageGraph graph;
+        // 两段式 handler 的 decode 在线程池上分块执行
+        auto decodeAll = [&graph](std::vector<InstallItem>& items) {
+            graph.ParallelFor(items.size(), [&items](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    Decode(items[i]);
+            });
+        };
 
         /* ===============================
          * 1. Create Nodes
          * =============================== */
-        status = JsonDomain::Node;
-        NS_LOG_DEBUG("[10%] Install Stage 1/10: Create Nodes");
-        for (const auto& jNode : handleJson[JsonDomain::Node])
-        {
-            currentNodeId = jNode.at("nodeId").get<uint32_t>();
-            auto fn = GetRegistry(JsonDomain::Node, "default");
-            fn(jNode);
-        }
+        std::vector<InstallItem> nodes;
+        graph.Add({"Create Nodes",
+                   {},
+                   [&] {
+                       nodes.reserve(jNodes.size());
+                       for (const auto& jNode : jNodes)
+                       {
+                           // 分区时每个 rank 创建全部节点，子集之外的节点不创建
+                           const uint32_t nodeId = jNode.at("nodeId").get<uint32_t>();
+                           if (!IsNodeSelected(nodeId))
+                               continue;
+                           nodes.push_back(Prepare(JsonDomain::Node, kDefault, jNode, nodeId));
+                       }
+                       decodeAll(nodes);
+                   },
+                   [&] {
+                       status = JsonDomain::Node;
+                       NS_LOG_DEBUG("[10%] Install Stage 1/10: Create Nodes");
+                       invokeAll(JsonDomain::Node, nodes);
+                   },
+                   {DomainName(JsonDomain::Node)}});
 
         /* ===============================
          * 2. Install Links
          * =============================== */
-        status = JsonDomain::Link;
-        NS_LOG_DEBUG("[20%] Install Stage 2/10: Install Links");
-        for (const auto& jLink : handleJson[JsonDomain::Link])
-        {
-            std::string type = jLink.at("type").get<std::string>();
-            currentLinkId = jLink.at("linkId").get<uint32_t>();
-            auto fn = GetRegistry(JsonDomain::Link, type);
-            fn(jLink);
-        }
+        // fn 为空的条目是本 rank 不安装的链路
+        std::vector<InstallItem> links;
+        graph.Add({"Install Links",
+                   {"Create Nodes"},
+                   [&] {
+                       links.reserve(jLinks.size());
+                       for (const auto& jLink : jLinks)
+                       {
+                           const uint32_t linkId = jLink.at("linkId").get<uint32_t>();
+                           if (!IsLinkInstalled(linkId))
+                           {
+                               links.push_back({&jLink, nullptr, nullptr, linkId, nullptr, nullptr});
+                               continue;
+                           }
+                           links.push_back(
+                               Prepare(JsonDomain::Link, typeOf(jLink, "type"), jLink, linkId));
+                       }
+                       decodeAll(links);
+                   },
+                   [&] {
+                       status = JsonDomain::Link;
+                       NS_LOG_DEBUG("[20%] Install Stage 2/10: Install Links");
+                       for (const auto& item : links)
+                       {
+                           currentLinkId = item.id;
+                           if (!item.fn)
+                           {
+                               // 子集之外的链路在任何 rank 上都不安装，不需要占位
+                               if (!partition || (subset && !subset->ContainsLink(item.id)))
+                                   continue;
+                               // 边界节点补占位设备，保持其 ifIndex 与所属 rank 一致
+                               for (const auto& jDev : item.j->at("netDevices"))
+                               {
+                                   uint32_t nodeId = jDev.at("nodeId").get<uint32_t>();
+                                   if (partition->IsBoundaryNode(nodeId))
+                                   {
+                                       Names::Find<Node>("node" + std::to_string(nodeId))
+                                           ->AddDevice(CreateObject<SimpleNetDevice>());
+                                   }
+                               }
+                               continue;
+                           }
+                           Invoke(JsonDomain::Link, item);
+                       }
+                   },
+                   {DomainName(JsonDomain::Link)}});
+
         /* ===============================
          * 3. Internet Stack
          * =============================== */
-        status = JsonDomain::Internet;
-        NS_LOG_DEBUG("[30%] Install Stage 3/10: Internet Stack");
-        {
-            auto fn = GetRegistry(JsonDomain::Internet, "default");
-            fn(handleJson[JsonDomain::Internet]);
-        }
+        InstallItem internet{};
+        graph.Add({"Internet Stack",
+                   {"Install Links"},
+                   [&] { internet = Prepare(JsonDomain::Internet, kDefault, jInternet); },
+                   [&] {
+                       status = JsonDomain::Internet;
+                       NS_LOG_DEBUG("[30%] Install Stage 3/10: Internet Stack");
+                       Invoke(JsonDomain::Internet, internet);
+                   },
+                   {DomainName(JsonDomain::Internet),
+                    DomainName(JsonDomain::Ipv4RoutingProtocol),
+                    DomainName(JsonDomain::Ipv6RoutingProtocol)}});
+
         /* ===============================
          * 4. IPv4 / IPv6 Network
          * =============================== */
-        status = JsonDomain::Ipv4Network;
-        NS_LOG_DEBUG("[40%] Install Stage 4/10: IPv4 / IPv6 Network");
-        for (const auto& j : handleJson[JsonDomain::Ipv4Network])
-        {
-            auto fn = GetRegistry(JsonDomain::Ipv4Network, "default");
-            fn(j);
-        }
-        status = JsonDomain::Ipv6Network;
-        for (const auto& j : handleJson[JsonDomain::Ipv6Network])
-        {
-            auto fn = GetRegistry(JsonDomain::Ipv6Network, "default");
-            fn(j);
-        }
+        std::vector<InstallItem> ipv4Networks;
+        std::vector<InstallItem> ipv6Networks;
+        graph.Add({"IPv4 / IPv6 Network",
+                   {"Internet Stack"},
+                   [&] {
+                       for (const auto& j : jIpv4Networks)
+                           ipv4Networks.push_back(Prepare(JsonDomain::Ipv4Network, kDefault, j));
+                       for (const auto& j : jIpv6Networks)
+                           ipv6Networks.push_back(Prepare(JsonDomain::Ipv6Network, kDefault, j));
+                       decodeAll(ipv4Networks);
+                       decodeAll(ipv6Networks);
+                   },
+                   [&] {
+                       NS_LOG_DEBUG("[40%] Install Stage 4/10: IPv4 / IPv6 Network");
+                       status = JsonDomain::Ipv4Network;
+                       for (const auto& item : ipv4Networks)
+                           Invoke(JsonDomain::Ipv4Network, item);
+                       status = JsonDomain::Ipv6Network;
+                       for (const auto& item : ipv6Networks)
+                           Invoke(JsonDomain::Ipv6Network, item);
+                   },
+                   {DomainName(JsonDomain::Ipv4Network), DomainName(JsonDomain::Ipv6Network)}});
+
         /* ===============================
          * 5. IPv4 / IPv6 Routing extra-config
          * =============================== */
-        NS_LOG_DEBUG("[50%] Install Stage 5/10: IPv4 / IPv6 Routing (Extra Config)");
-        if (!enableGlobalRouting)
-        {
-            status = (JsonDomain::Ipv4RoutingProtocol);
-            for (const auto& jProto : handleJson[JsonDomain::Ipv4RoutingProtocol])
-            {
-                currentNodeId = jProto.at("nodeId").get<uint32_t>();
-                for (const auto& jRouting : jProto.at("ipv4RoutingList"))
-                {
-                    auto fn = GetRegistry(JsonDomain::Ipv4RoutingProtocol,
-                                          jRouting.at("type").get<std::string>());
-                    fn(jRouting);
-                }
-            }
-            status = (JsonDomain::Ipv6RoutingProtocol);
-            for (const auto& jProto : handleJson[JsonDomain::Ipv6RoutingProtocol])
-            {
-                currentNodeId = jProto.at("nodeId").get<uint32_t>();
-                for (const auto& jRouting : jProto.at("ipv6RoutingList"))
-                {
-                    auto fn = GetRegistry(JsonDomain::Ipv6RoutingProtocol,
-                                          jRouting.at("type").get<std::string>());
-                    fn(jRouting);
-                }
-            }
-        }
+        // 与 Validate 一致：开启全局 / nix 路由时不解析路由文件
+        std::vector<InstallItem> ipv4Routes;
+        std::vector<InstallItem> ipv6Routes;
+        graph.Add({"IPv4 / IPv6 Routing",
+                   {"IPv4 / IPv6 Network"},
+                   [&] {
+                       if (UsesNetworkWideRouting(jInternet))
+                           return;
+                       auto collect = [&](JsonDomain domain,
+                                          const json& jProtos,
+                                          const char* listKey,
+                                          std::vector<InstallItem>& out) {
+                           for (const auto& jProto : jProtos)
+                           {
+                               const uint32_t nodeId = jProto.at("nodeId").get<uint32_t>();
+                               if (!IsNodeInstalled(nodeId))
+                                   continue;
+                               for (const auto& jRouting : jProto.at(listKey))
+                               {
+                                   out.push_back(
+                                       Prepare(domain, typeOf(jRouting, "type"), jRouting, nodeId));
+                               }
+                           }
+                       };
+                       collect(JsonDomain::Ipv4RoutingProtocol,
+                               jIpv4Routing,
+                               "ipv4RoutingList",
+                               ipv4Routes);
+                       collect(JsonDomain::Ipv6RoutingProtocol,
+                               jIpv6Routing,
+                               "ipv6RoutingList",
+                               ipv6Routes);
+                       decodeAll(ipv4Routes);
+                       decodeAll(ipv6Routes);
+                   },
+                   [&] {
+                       NS_LOG_DEBUG("[50%] Install Stage 5/10: IPv4 / IPv6 Routing (Extra Config)");
+                       if (UsesNetworkWideRouting(jInternet))
+                           return;
+                       status = JsonDomain::Ipv4RoutingProtocol;
+                       invokeAll(JsonDomain::Ipv4RoutingProtocol, ipv4Routes);
+                       status = JsonDomain::Ipv6RoutingProtocol;
+                       invokeAll(JsonDomain::Ipv6RoutingProtocol, ipv6Routes);
+                   },
+                   {DomainName(JsonDomain::Internet),
+                    DomainName(JsonDomain::Ipv4RoutingProtocol),
+                    DomainName(JsonDomain::Ipv6RoutingProtocol)}});
+
         /* ===============================
          * 6. Node Roles
          * =============================== */
-        status = JsonDomain::Node;
-        NS_LOG_DEBUG("[60%] Install Stage 6/10: Node Roles");
-        for (const auto& jNode : handleJson[JsonDomain::Node])
-        {
-            if (!jNode.contains("role"))
-                continue;
+        std::vector<InstallItem> roles;
+        graph.Add({"Node Roles",
+                   {"IPv4 / IPv6 Routing"},
+                   [&] {
+                       for (const auto& jNode : jNodes)
+                       {
+                           if (!jNode.contains("role"))
+                               continue;
+                           const uint32_t nodeId = jNode.at("nodeId").get<uint32_t>();
+                           if (!IsNodeInstalled(nodeId))
+                               continue;
+                           roles.push_back(
+                               Prepare(JsonDomain::Node, typeOf(jNode, "role"), jNode, nodeId));
+                       }
+                       decodeAll(roles);
+                   },
+                   [&] {
+                       status = JsonDomain::Node;
+                       NS_LOG_DEBUG("[60%] Install Stage 6/10: Node Roles");
+                       invokeAll(JsonDomain::Node, roles);
+                   },
+                   {DomainName(JsonDomain::Node)}});
 
-            currentNodeId = jNode.at("nodeId").get<uint32_t>();
-            auto fn = GetRegistry(JsonDomain::Node, jNode.at("role").get<std::string>());
-            fn(jNode);
-        }
         /* ===============================
          * 7. Mobility
          * =============================== */
-        status = JsonDomain::Mobility;
-        NS_LOG_DEBUG("[70%] Install Stage 7/10: Mobility");
-        for (const auto& jMob : handleJson[JsonDomain::Mobility])
-        {
-            currentNodeId = jMob.at("nodeId").get<uint32_t>();
-            auto fn = GetRegistry(JsonDomain::Mobility, jMob.at("type").get<std::string>());
-            fn(jMob);
-        }
+        std::vector<InstallItem> mobility;
+        graph.Add({"Mobility",
+                   {"Create Nodes"},
+                   [&] {
+                       mobility.reserve(jMobility.size());
+                       for (const auto& jMob : jMobility)
+                       {
+                           const uint32_t nodeId = jMob.at("nodeId").get<uint32_t>();
+                           if (!IsNodeInstalled(nodeId))
+                               continue;
+                           mobility.push_back(
+                               Prepare(JsonDomain::Mobility, typeOf(jMob, "type"), jMob, nodeId));
+                       }
+                       decodeAll(mobility);
+                   },
+                   [&] {
+                       status = JsonDomain::Mobility;
+                       NS_LOG_DEBUG("[70%] Install Stage 7/10: Mobility");
+                       invokeAll(JsonDomain::Mobility, mobility);
+                   },
+                   {DomainName(JsonDomain::Mobility)}});
+
         /* ===============================
          * 8. Application
          * =============================== */
-        status = JsonDomain::Application;
-        NS_LOG_DEBUG("[80%] Install Stage 8/10: Application");
-        for (const auto& jApp : handleJson[JsonDomain::Application])
+        std::vector<InstallItem> applications;
+        graph.Add({"Application",
+                   {"IPv4 / IPv6 Network"},
+                   [&] {
+                       // 远端节点或链路不在子集中、或远端是被合并的交换机时无法解析地址，
+                       // 应用一并跳过
+                       auto remoteSelected = [this](const json& jApp) {
+                           if ((!subset && !segments) || !jApp.contains("socket") ||
+                               !jApp.at("socket").contains("netDeviceId"))
+                               return true;
+                           const auto& jDev = jApp.at("socket").at("netDeviceId");
+                           if (jDev.contains("nodeId"))
+                           {
+                               const uint32_t remoteId = jDev.at("nodeId").get<uint32_t>();
+                               if ((subset && !subset->ContainsNode(remoteId)) ||
+                                   (segments && segments->IsCollapsed(remoteId)))
+                                   return false;
+                           }
+                           return !subset || !jDev.contains("linkId") ||
+                                  subset->ContainsLink(jDev.at("linkId").get<uint32_t>());
+                       };
+                       applications.reserve(jApplications.size());
+                       for (const auto& jApp : jApplications)
+                       {
+                           const uint32_t nodeId = jApp.at("nodeId").get<uint32_t>();
+                           if (!IsNodeOwned(nodeId) || !remoteSelected(jApp))
+                               continue;
+                           applications.push_back(Prepare(JsonDomain::Application,
+                                                          typeOf(jApp, "type"),
+                                                          jApp,
+                                                          nodeId));
+                       }
+                       decodeAll(applications);
+                   },
+                   [&] {
+                       status = JsonDomain::Application;
+                       NS_LOG_DEBUG("[80%] Install Stage 8/10: Application");
+                       invokeAll(JsonDomain::Application, applications);
+                   },
+                   {DomainName(JsonDomain::Application)}});
+
+        /* ===============================
+         * Extra stages
+         * =============================== */
+        std::vector<std::string> allStages = {"Create Nodes",
+                                              "Install Links",
+                                              "Internet Stack",
+                                              "IPv4 / IPv6 Network",
+                                              "IPv4 / IPv6 Routing",
+                                              "Node Roles",
+                                              "Mobility",
+                                              "Application"};
+        for (const auto& stage : extraStages)
         {
-            currentNodeId = jApp.at("nodeId").get<uint32_t>();
-            auto fn = GetRegistry(JsonDomain::Application, jApp.at("type").get<std::string>());
-            fn(jApp);
+            graph.Add(stage);
+            allStages.push_back(stage.name);
         }
 
+        /* ===============================
+         * Timeline
+         * =============================== */
+        // 修改的目标可能是任何阶段创建的对象，排在所有安装阶段之后
+        InstallItem timeline{};
+        graph.Add({"Timeline",
+                   allStages,
+                   [&] {
+                       if (jTimeline.empty())
+                           return;
+                       timeline = Prepare(JsonDomain::Timeline, kDefault, jTimeline);
+                       Decode(timeline);
+                   },
+                   [&] {
+                       if (!timeline.j)
+                           return;
+                       status = JsonDomain::Timeline;
+                       NS_LOG_DEBUG("[85%] Install Stage: Timeline");
+                       Invoke(JsonDomain::Timeline, timeline);
+                       timeline.decoded.reset();
+                   },
+                   {DomainName(JsonDomain::Timeline)}});
+        allStages.push_back("Timeline");
+
         /* ===============================
          * 9. Simulator
          * =============================== */
-        NS_LOG_DEBUG("[90%] Install Stage 9/10: Simulator");
+        InstallItem simulator{};
+        graph.Add({"Simulator",
+                   allStages,
+                   [&] { simulator = Prepare(JsonDomain::Simulator, kDefault, jSimulator); },
+                   [&] {
+                       status = JsonDomain::Simulator;
+                       NS_LOG_DEBUG("[90%] Install Stage 9/10: Simulator");
+                       Invoke(JsonDomain::Simulator, simulator);
+                   },
+                   {DomainName(JsonDomain::Simulator)}});
+
+        // 各阶段 reads 中的 domain 在最后一个读取者 install 后释放
+        // 开启内存统计时先记下释放前的占用，报告中与 Install 后的保留量并列
+        std::map<JsonDomain, JsonCensus> heldJson;
+        std::function<void(const std::string&)> release;
+        if (releaseJson)
         {
-            status = JsonDomain::Simulator;
-            auto fn = GetRegistry(JsonDomain::Simulator, "default");
-            fn(handleJson[JsonDomain::Simulator]);
+            release = [this, &heldJson](const std::string& name) {
+                for (const auto& [key, domain] : ConfigFileKeys())
+                {
+                    if (DomainName(domain) != name)
+                        continue;
+                    if (profiler.IsMemoryEnabled())
+                        heldJson[domain] = MeasureJson(*this, domain);
+                    ReleaseJson(domain);
+                }
+            };
         }
+        graph.Run(installThreads, profiler, release);
+        profiler.EndStage();
         NS_LOG_DEBUG("[100%] Install Stage 10/10: Finish");
+        if (profiler.IsMemoryEnabled())
+            RecordMemoryCensus(*this, heldJson);
+        profiler.Write(OutputPath(profiler.GetPath()));
     }
     catch (const std::exception& e)
     {
         NS_FATAL_ERROR("ConfigJson Install failed: " << e.what());
     }
 }
+
+void
+ConfigJsonHelper::WarmUpScheduler()
+{
+    if (!schedulerWarmup)
+        return;
+    try
+    {
+        // 单独一个阶段，报告在 Install 写出后再更新一次
+        profiler.BeginStage("Scheduler Warm-up");
+        schedulerWarmup();
+        schedulerWarmup = nullptr;
+        profiler.EndStage();
+        profiler.Write(OutputPath(profiler.GetPath()));
+    }
+    catch (const std::exception& e)
+    {
+        NS_FATAL_ERROR("ConfigJson scheduler warm-up failed: " << e.what());
+    }
+}
 } // namespace configjson2
 } // namespace ns3
\ No newline at end of file
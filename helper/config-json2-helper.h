@@ -6,20 +6,35 @@
 #ifndef CONFIG_JSON_HELPER_H
 #define CONFIG_JSON_HELPER_H
 
+#include "config-json2-json.h"
+#include "config-json2-partition.h"
+#include "config-json2-profiler.h"
+#include "config-json2-stage-graph.h"
+
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/network-module.h"
 
 #include <boost/filesystem.hpp>
 #include <memory>
-#include <nlohmann/json.hpp>
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
 namespace configjson2
 {
-using json = nlohmann::json;
-using HandlerFn = std::function<void(const nlohmann::json&)>;
+using HandlerFn = std::function<void(const json&)>;
+
+// 两段式 handler 的类型擦除形式，见 ConfigJsonCore::RegisterSplit
+struct SplitHandlerFn
+{
+    std::function<std::shared_ptr<const void>(const json&)> decode;
+    std::function<void(const void*)> apply;
+};
+
+class ProfileSet;
+class ApplicationCounterSampler;
 
 // 决定分发粒度
 enum class JsonDomain
@@ -34,37 +49,157 @@ enum class JsonDomain
     Ipv6RoutingProtocol,
     Mobility,
     Application,
+    Timeline,
     Simulator
 };
 
+const std::string& DomainName(JsonDomain domain);
+// config.json 中子文件的键及对应 domain，按加载顺序
+const std::vector<std::pair<std::string, JsonDomain>>& ConfigFileKeys();
+
 class ConfigJsonCore
 {
   public:
     virtual void Install(boost::filesystem::path configPath) = 0;
     void Register(JsonDomain, std::string, HandlerFn);
+    /**
+     * 注册两段式 handler：
+     * - decode：把 json 解析成 T，只读 json、不访问 ns-3 对象和 helper 的可变状态，
+     *   须线程安全；Install 时在工作线程上对整个 domain 并行执行
+     * - apply：按 T 创建 ns-3 对象，在主线程执行
+     * 同时登记 apply(decode(j)) 作为普通 HandlerFn，GetRegistry / Invoke 照常可用。
+     */
+    template <typename T>
+    void RegisterSplit(JsonDomain domain,
+                       std::string type,
+                       std::function<T(const json&)> decode,
+                       std::function<void(const T&)> apply);
     HandlerFn GetRegistry(JsonDomain domain, const std::string& type) const;
+    // 未注册时返回 nullptr；指针在注册表不再改动期间有效
+    const HandlerFn* FindHandler(JsonDomain domain, const std::string& type) const;
+    // 只对 RegisterSplit 注册的 type 返回非空
+    const SplitHandlerFn* FindSplitHandler(JsonDomain domain, const std::string& type) const;
 
   protected:
     std::map<JsonDomain, std::map<std::string, HandlerFn>> m_registry;
+    std::map<JsonDomain, std::map<std::string, SplitHandlerFn>> m_splitRegistry;
+};
+
+template <typename T>
+void
+ConfigJsonCore::RegisterSplit(JsonDomain domain,
+                              std::string type,
+                              std::function<T(const json&)> decode,
+                              std::function<void(const T&)> apply)
+{
+    Register(domain, type, [decode, apply](const json& j) { apply(decode(j)); });
+    SplitHandlerFn split;
+    split.decode = [decode](const json& j) -> std::shared_ptr<const void> {
+        return std::make_shared<const T>(decode(j));
+    };
+    split.apply = [apply](const void* decoded) { apply(*static_cast<const T*>(decoded)); };
+    m_splitRegistry[domain][type] = std::move(split);
+}
+
+// 阶段 prepare 生成的一次 handler 调用，install 时直接执行
+struct InstallItem
+{
+    const json* j;
+    const HandlerFn* fn;
+    const std::string* type;
+    uint32_t id; // nodeId / linkId
+    // 两段式 handler：prepare 阶段填好 decoded，install 时只执行 apply
+    const SplitHandlerFn* split = nullptr;
+    std::shared_ptr<const void> decoded;
 };
 
 class ConfigJsonHelper : public ConfigJsonCore
 {
   public:
     static ConfigJsonHelper Default();
+    // 等价于 Load(configPath) 后 Install()
     void Install(boost::filesystem::path configPath) override;
+    // 只读取 config.json 及各子文件并校验，不创建任何 ns-3 对象
+    void Load(boost::filesystem::path configPath);
+    // 检查每个元素引用的 handler 是否已注册，汇总全部错误后抛出 invalid_argument
+    void Validate() const;
+    // 按已加载的 handleJson 安装（Stage 1-9）
+    void Install();
+    // simulator.json 的 "scheduler": "auto"：预热并选定调度器，会推进仿真时间。
+    // 须在 Install() 之后、Simulator::Run() 之前调用；未使用 auto 时什么也不做
+    void WarmUpScheduler();
+    // 读取并解析一个 JSON 文件，节点分配在调用线程当前的 JsonArena 中（没有则用 operator new）
     static json LoadJson(boost::filesystem::path path);
+    // config.json 中子文件键的值展开为文件列表：单个路径、glob（按路径名排序）、
+    // 序号区间（apps-000..127.json）或它们组成的数组（按数组顺序）；相对路径基于 baseDir
+    static std::vector<boost::filesystem::path> ExpandShards(const boost::filesystem::path& baseDir,
+                                                             const json& spec);
+    // 把文件读入 handleJson[domain]，DOM 分配在该 domain 独占的 arena 中
+    void LoadDomain(JsonDomain domain, const boost::filesystem::path& path);
+    // 用至多 installThreads + 1 个线程并行解析各分片，每个分片一个 arena；
+    // 按顺序合并：数组拼接，对象合并（键重复时抛出 invalid_argument）
+    void LoadDomain(JsonDomain domain, const std::vector<boost::filesystem::path>& paths);
+    // 释放 handleJson[domain] 及其 arena，保留空的条目
+    void ReleaseJson(JsonDomain domain);
+    // 查找并调用 handler，未注册的 type 抛出异常；开启 profiler 时计时
+    void Invoke(JsonDomain domain, const std::string& type, const json& j);
+    // 查找 handler 生成调用条目，未注册时抛出 invalid_argument；不修改 helper，可在工作线程调用。
+    // type 和 j 须在 install 前保持有效
+    InstallItem Prepare(JsonDomain domain,
+                        const std::string& type,
+                        const json& j,
+                        uint32_t id = UINT32_MAX) const;
+    // 对两段式 handler 的条目执行 decode，可在工作线程调用
+    static void Decode(InstallItem& item);
+    // 执行 handler；两段式 handler 未 decode 时先在本线程 decode
+    void Invoke(JsonDomain domain, const InstallItem& item);
     // 必要变量存储，helper存储并维护，fn只读
     boost::filesystem::path configPath;
+    // 须在 handleJson 之前声明：析构时先销毁 DOM，再归还 arena
+    std::map<JsonDomain, std::vector<std::shared_ptr<JsonArena>>> jsonArenas;
     std::map<JsonDomain, json> handleJson;
     // 常用变量存储，helper存储并维护，fn只读
     uint32_t currentNodeId = UINT32_MAX;
     uint32_t currentLinkId = UINT32_MAX;
     JsonDomain status = JsonDomain::Config; // 当前阶段
     // 额外变量存储，helper作存储，fn维护
+    // 只表示安装了 Ipv4GlobalRouting；nix-vector 等不读路由文件的情况见 internet-stack.json
     bool enableGlobalRouting = false;
     std::unique_ptr<Ipv4ListRoutingHelper> ipv4List;
     std::unique_ptr<Ipv6ListRoutingHelper> ipv6List;
+    // config.json 中 "profiles" 的解码结果，由 ConfigHandler 设置
+    std::shared_ptr<ProfileSet> profiles;
+    // applications.json 中写了 "counters" 的应用，由应用 handler 登记、SimulatorHandler 启动
+    std::shared_ptr<ApplicationCounterSampler> appCounters;
+    InstallProfiler profiler;
+    // Install 时执行各阶段 prepare 的工作线程数，0 表示全部在主线程执行
+    uint32_t installThreads = 4;
+    // Install 时每个子文件 domain 在最后一个读取它的阶段完成后即释放（config.json 仍保留）
+    bool releaseJson = true;
+    // 扩展的安装阶段，按 after 插入依赖图；Simulator 阶段总在最后。
+    // 读取 handleJson 的扩展阶段须在 reads 中列出 DomainName(domain)，否则可能读到已释放的条目
+    std::vector<StageGraph::Stage> extraStages;
+    // "scheduler": "auto" 的预热，由 SimulatorHandler 设置，WarmUpScheduler() 执行后清空
+    std::function<void()> schedulerWarmup;
+    // 分布式安装时本 rank 的成员关系，为空表示安装全部
+    std::unique_ptr<TopologyPartition> partition;
+    // config.json 的 "subset" 选中的部分，为空表示全部
+    std::unique_ptr<TopologySubset> subset;
+    // config.json 的 "collapseSwitches" 合并的交换段，为空表示不合并
+    std::unique_ptr<SwitchedSegments> segments;
+    uint32_t GetSystemId(uint32_t nodeId) const;
+    // 节点在子集中（分区时所有 rank 都创建它）
+    bool IsNodeSelected(uint32_t nodeId) const;
+    bool IsNodeOwned(uint32_t nodeId) const;
+    bool IsNodeInstalled(uint32_t nodeId) const;
+    bool IsLinkInstalled(uint32_t linkId) const;
+    // 节点在该链路上有设备（node<n>-link<l>）：二者都已安装，且节点不是被合并的交换机
+    bool IsDeviceInstalled(uint32_t nodeId, uint32_t linkId) const;
+    // 输出文件路径：附加 outputTag，分布式时再附加 -rank<r>
+    std::string OutputPath(const std::string& path) const;
+    std::string outputTag;
+    // 可跨 run 合并的输出（基础路径，格式 csv | jsonl | binary），由 SimulatorHandler 登记
+    std::vector<std::pair<std::string, std::string>> mergeableOutputs;
 };
 } // namespace configjson2
 
@@ -0,0 +1,111 @@
+#include "config-json2-json.h"
+
+#include <algorithm>
+#include <new>
+
+namespace ns3
+{
+namespace configjson2
+{
+namespace
+{
+// 块头：来源 arena，operator new 分配的为 nullptr
+constexpr std::size_t kHeader = 8;
+// 不小于该值的块直接走 operator new：数组扩容时旧缓冲区能真正释放，不在 arena 中留下空洞
+constexpr std::size_t kLargeBlock = 64 * 1024;
+
+thread_local JsonArena* t_current = nullptr;
+
+std::size_t
+RoundUp(std::size_t bytes)
+{
+    return (bytes + 7) & ~std::size_t(7);
+}
+} // namespace
+
+JsonArena::JsonArena(std::size_t chunkBytes)
+    : m_chunkBytes(std::max<std::size_t>(chunkBytes, 4096))
+{
+}
+
+JsonArena::~JsonArena() = default;
+
+void*
+JsonArena::Allocate(std::size_t bytes)
+{
+    bytes = RoundUp(bytes);
+    if (static_cast<std::size_t>(m_end - m_cursor) < bytes)
+    {
+        const std::size_t size = std::max(m_chunkBytes, bytes);
+        m_chunks.emplace_back(new char[size]);
+        m_cursor = m_chunks.back().get();
+        m_end = m_cursor + size;
+        m_reserved += size;
+    }
+    void* p = m_cursor;
+    m_cursor += bytes;
+    m_used += bytes;
+    return p;
+}
+
+std::size_t
+JsonArena::ReservedBytes() const
+{
+    return m_reserved;
+}
+
+std::size_t
+JsonArena::UsedBytes() const
+{
+    return m_used;
+}
+
+JsonArena::Scope::Scope(JsonArena* arena)
+    : m_previous(t_current)
+{
+    t_current = arena;
+}
+
+JsonArena::Scope::~Scope()
+{
+    t_current = m_previous;
+}
+
+JsonArena*
+JsonArena::Current()
+{
+    return t_current;
+}
+
+namespace detail
+{
+void*
+ArenaAllocate(std::size_t bytes)
+{
+    JsonArena* arena = t_current;
+    char* base;
+    if (arena && bytes < kLargeBlock)
+    {
+        base = static_cast<char*>(arena->Allocate(kHeader + bytes));
+    }
+    else
+    {
+        arena = nullptr;
+        base = static_cast<char*>(::operator new(kHeader + bytes));
+    }
+    *reinterpret_cast<JsonArena**>(base) = arena;
+    return base + kHeader;
+}
+
+void
+ArenaDeallocate(void* p) noexcept
+{
+    if (!p)
+        return;
+    char* base = static_cast<char*>(p) - kHeader;
+    if (*reinterpret_cast<JsonArena**>(base) == nullptr)
+        ::operator delete(base);
+}
+} // namespace detail
+} // namespace configjson2
+} // namespace ns3
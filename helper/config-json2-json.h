@@ -0,0 +1,126 @@
+/**
+ * @file config-json2-json.h
+ * @brief Arena-backed nlohmann::basic_json used for loaded configuration files.
+ */
+
+#ifndef CONFIG_JSON_JSON_H
+#define CONFIG_JSON_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * 单调增长的内存池：一个子 JSON 文件的 DOM 全部分配在同一个 arena 中，
+ * 分配只是移动指针，释放时整个 arena 一次归还。
+ *
+ * 通过 Scope 把 arena 设为本线程的当前 arena，作用域内经 ArenaAllocator 的分配
+ * （对象、数组、map 节点、string 对象）都来自它；作用域外的分配走 operator new。
+ * 每块前有 8 字节记录来源，因此两种来源的值可以混在同一棵树里，
+ * 来自 arena 的块释放时什么也不做，内存随 arena 析构一并归还。
+ * 字符串内容仍由 std::string 自己分配（短字符串在对象内部，不额外分配）。
+ */
+class JsonArena
+{
+  public:
+    explicit JsonArena(std::size_t chunkBytes = 1 << 20);
+    ~JsonArena();
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    // 返回 8 字节对齐的内存，不单独释放
+    void* Allocate(std::size_t bytes);
+    // 已向系统申请的字节数
+    std::size_t ReservedBytes() const;
+    // 已分配出去的字节数（含块头）
+    std::size_t UsedBytes() const;
+
+    // RAII：作用域内本线程的 ArenaAllocator 从 arena 分配
+    class Scope
+    {
+      public:
+        explicit Scope(JsonArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        JsonArena* m_previous;
+    };
+
+    static JsonArena* Current();
+
+  private:
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char* m_cursor = nullptr;
+    char* m_end = nullptr;
+    std::size_t m_chunkBytes;
+    std::size_t m_reserved = 0;
+    std::size_t m_used = 0;
+};
+
+namespace detail
+{
+void* ArenaAllocate(std::size_t bytes);
+void ArenaDeallocate(void* p) noexcept;
+} // namespace detail
+
+// 无状态分配器：nlohmann::basic_json 内部按需默认构造分配器，状态只能放在线程的当前 arena
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        static_assert(alignof(T) <= 8, "ArenaAllocator only provides 8-byte alignment");
+        return static_cast<T*>(detail::ArenaAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        detail::ArenaDeallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+using json = nlohmann::basic_json<std::map,
+                                  std::vector,
+                                  std::string,
+                                  bool,
+                                  std::int64_t,
+                                  std::uint64_t,
+                                  double,
+                                  ArenaAllocator>;
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_JSON_H
@@ -0,0 +1,818 @@
+#include "config-json2-partition.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Partition");
+
+namespace
+{
+// 收缩后的无向带权图：顶点权重为包含的节点数，边权为切开该边的代价
+struct PartitionGraph
+{
+    std::vector<uint64_t> weight;
+    std::vector<std::vector<std::pair<uint32_t, double>>> adj;
+};
+
+class UnionFind
+{
+  public:
+    explicit UnionFind(uint32_t n)
+        : m_parent(n)
+    {
+        std::iota(m_parent.begin(), m_parent.end(), 0);
+    }
+
+    uint32_t Find(uint32_t x)
+    {
+        while (m_parent[x] != x)
+        {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+
+    void Union(uint32_t a, uint32_t b)
+    {
+        a = Find(a);
+        b = Find(b);
+        if (a != b)
+            m_parent[std::max(a, b)] = std::min(a, b);
+    }
+
+  private:
+    std::vector<uint32_t> m_parent;
+};
+
+// p2p 链路的信道时延：链路自己的 channel.delay，其次是所引用 profile 的，
+// 都未配置时为 0（与 PointToPointChannel 默认值一致）
+Time
+LinkDelay(const json& jLink, const json* jProfiles)
+{
+    if (jLink.contains("channel") && jLink.at("channel").contains("delay"))
+        return Time(jLink.at("channel").at("delay").get<std::string>());
+    if (jProfiles && jLink.contains("profile"))
+    {
+        const auto& jProfile = jProfiles->at(jLink.at("profile").get<std::string>());
+        if (jProfile.contains("channel") && jProfile.at("channel").contains("delay"))
+            return Time(jProfile.at("channel").at("delay").get<std::string>());
+    }
+    return Time(0);
+}
+
+uint64_t
+Distance(uint64_t a, uint64_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+bool
+IsCuttable(const json& jLink, const json* jProfiles)
+{
+    return jLink.at("type").get<std::string>() == "p2p" && jLink.at("netDevices").size() == 2 &&
+           LinkDelay(jLink, jProfiles).IsStrictlyPositive();
+}
+
+/**
+ * 在 target 附近把图二分。side[v] == 0 的一侧权重落在 [lo, hi] 内。
+ * 先从伪外围顶点贪心生长（GGGP），再做若干轮 FM 细化。
+ */
+std::vector<uint8_t>
+Bisect(const PartitionGraph& g, uint64_t lo, uint64_t target, uint64_t hi)
+{
+    const uint32_t n = g.weight.size();
+    std::vector<uint8_t> side(n, 1);
+    if (n == 0)
+        return side;
+
+    /* ---------- 伪外围起点：两次 BFS ---------- */
+    auto farthest = [&](uint32_t s) {
+        std::vector<int32_t> dist(n, -1);
+        std::queue<uint32_t> q;
+        q.push(s);
+        dist[s] = 0;
+        uint32_t last = s;
+        while (!q.empty())
+        {
+            last = q.front();
+            q.pop();
+            for (const auto& [u, w] : g.adj[last])
+            {
+                if (dist[u] < 0)
+                {
+                    dist[u] = dist[last] + 1;
+                    q.push(u);
+                }
+            }
+        }
+        return last;
+    };
+    uint32_t start = farthest(farthest(0));
+
+    /* ---------- 贪心生长：每次加入与区域连接最强的顶点 ---------- */
+    std::vector<double> conn(n, 0);
+    std::priority_queue<std::pair<double, uint32_t>> pq;
+    uint64_t grown = 0;
+    uint32_t nextSeed = 0;
+    pq.emplace(0, start);
+    while (grown < target)
+    {
+        if (pq.empty())
+        {
+            // 不连通：从下一个未加入的顶点继续
+            while (nextSeed < n && side[nextSeed] == 0)
+                ++nextSeed;
+            if (nextSeed == n)
+                break;
+            pq.emplace(0, nextSeed);
+        }
+        auto [c, v] = pq.top();
+        pq.pop();
+        if (side[v] == 0 || c < conn[v])
+            continue; // 过期条目
+        if (grown + g.weight[v] > hi && grown >= lo)
+            break;
+        side[v] = 0;
+        grown += g.weight[v];
+        for (const auto& [u, w] : g.adj[v])
+        {
+            if (side[u] == 0)
+                continue;
+            conn[u] += w;
+            pq.emplace(conn[u], u);
+        }
+    }
+
+    /* ---------- FM 细化 ---------- */
+    uint64_t sideWeight[2] = {grown, 0};
+    for (uint32_t v = 0; v < n; ++v)
+        if (side[v] == 1)
+            sideWeight[1] += g.weight[v];
+    const uint64_t total = sideWeight[0] + sideWeight[1];
+
+    std::vector<double> gain(n);
+    std::vector<uint32_t> stamp(n, 0);
+    std::vector<uint8_t> locked(n);
+    constexpr uint32_t kMaxPasses = 10;
+    for (uint32_t pass = 0; pass < kMaxPasses; ++pass)
+    {
+        using Entry = std::tuple<double, uint32_t, uint32_t>; // gain, stamp, vertex
+        std::priority_queue<Entry> queues[2];
+        std::fill(locked.begin(), locked.end(), 0);
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            gain[v] = 0;
+            for (const auto& [u, w] : g.adj[v])
+                gain[v] += side[u] != side[v] ? w : -w;
+            queues[side[v]].emplace(gain[v], ++stamp[v], v);
+        }
+
+        std::vector<uint32_t> moves;
+        double delta = 0;
+        double bestDelta = 0;
+        uint64_t bestOffset = Distance(sideWeight[0], target);
+        std::size_t bestLen = 0;
+        // 连续若干步没有改进就提前结束本轮
+        const std::size_t patience = std::max<std::size_t>(64, n / 50);
+
+        while (moves.size() - bestLen < patience)
+        {
+            int32_t pick = -1;
+            double pickGain = 0;
+            for (int s = 0; s < 2; ++s)
+            {
+                auto& q = queues[s];
+                while (!q.empty() &&
+                       (locked[std::get<2>(q.top())] ||
+                        std::get<1>(q.top()) != stamp[std::get<2>(q.top())]))
+                    q.pop();
+                if (q.empty())
+                    continue;
+                uint32_t v = std::get<2>(q.top());
+                const uint64_t left =
+                    s == 0 ? sideWeight[0] - g.weight[v] : sideWeight[0] + g.weight[v];
+                if (left < lo || left > hi)
+                    continue; // 该侧队首不满足平衡约束
+                if (pick < 0 || gain[v] > pickGain)
+                {
+                    pick = v;
+                    pickGain = gain[v];
+                }
+            }
+            if (pick < 0)
+                break;
+
+            const uint32_t v = pick;
+            const uint8_t from = side[v];
+            locked[v] = 1;
+            side[v] = 1 - from;
+            sideWeight[from] -= g.weight[v];
+            sideWeight[1 - from] += g.weight[v];
+            delta -= gain[v];
+            moves.push_back(v);
+            for (const auto& [u, w] : g.adj[v])
+            {
+                if (locked[u])
+                    continue;
+                gain[u] += side[u] == side[v] ? -2 * w : 2 * w;
+                queues[side[u]].emplace(gain[u], ++stamp[u], u);
+            }
+
+            // 割更小，或割相同但更均衡
+            const uint64_t offset = Distance(sideWeight[0], target);
+            if (delta < bestDelta - 1e-12 ||
+                (delta <= bestDelta + 1e-12 && offset < bestOffset))
+            {
+                bestDelta = delta;
+                bestOffset = offset;
+                bestLen = moves.size();
+            }
+        }
+
+        // 回滚最佳前缀之后的移动
+        for (std::size_t i = moves.size(); i > bestLen; --i)
+        {
+            const uint32_t v = moves[i - 1];
+            sideWeight[side[v]] -= g.weight[v];
+            side[v] = 1 - side[v];
+            sideWeight[side[v]] += g.weight[v];
+        }
+        if (bestLen == 0 || bestDelta > -1e-12)
+            break;
+    }
+    NS_ASSERT(sideWeight[0] + sideWeight[1] == total);
+    return side;
+}
+
+// 递归二分：把 vertices 划入 [firstPart, firstPart + parts)
+void
+PartitionRecursive(const PartitionGraph& g,
+                   const std::vector<uint32_t>& vertices,
+                   uint32_t parts,
+                   uint32_t firstPart,
+                   double imbalance,
+                   std::vector<int32_t>& local,
+                   std::vector<uint32_t>& result)
+{
+    if (parts == 1 || vertices.size() <= 1)
+    {
+        for (uint32_t v : vertices)
+            result[v] = firstPart;
+        return;
+    }
+
+    /* ---------- 诱导子图 ---------- */
+    PartitionGraph sub;
+    sub.weight.resize(vertices.size());
+    sub.adj.resize(vertices.size());
+    for (uint32_t i = 0; i < vertices.size(); ++i)
+        local[vertices[i]] = i;
+    uint64_t total = 0;
+    uint64_t heaviest = 0;
+    for (uint32_t i = 0; i < vertices.size(); ++i)
+    {
+        const uint32_t v = vertices[i];
+        sub.weight[i] = g.weight[v];
+        total += g.weight[v];
+        heaviest = std::max(heaviest, g.weight[v]);
+        for (const auto& [u, w] : g.adj[v])
+            if (local[u] >= 0)
+                sub.adj[i].emplace_back(local[u], w);
+    }
+    for (uint32_t v : vertices)
+        local[v] = -1;
+
+    const uint32_t leftParts = parts / 2;
+    const uint64_t target = total * leftParts / parts;
+    const uint64_t tol =
+        std::max<uint64_t>(std::ceil(imbalance * total * leftParts / parts), heaviest);
+    const uint64_t lo = target > tol ? target - tol : 0;
+    const uint64_t hi = std::min(total, target + tol);
+
+    std::vector<uint8_t> side = Bisect(sub, lo, target, hi);
+
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+    for (uint32_t i = 0; i < vertices.size(); ++i)
+        (side[i] == 0 ? left : right).push_back(vertices[i]);
+
+    PartitionRecursive(g, left, leftParts, firstPart, imbalance, local, result);
+    PartitionRecursive(g, right, parts - leftParts, firstPart + leftParts, imbalance, local, result);
+}
+
+std::vector<uint32_t>
+EndpointIds(const json& jLink)
+{
+    std::vector<uint32_t> ids;
+    for (const auto& dev : jLink.at("netDevices"))
+        ids.push_back(dev.at("nodeId").get<uint32_t>());
+    return ids;
+}
+} // namespace
+
+/* ===============================
+ * TopologyPartition
+ * =============================== */
+std::unordered_map<uint32_t, uint32_t>
+TopologyPartition::Compute(const json& jNodes,
+                           const json& jLinks,
+                           uint32_t parts,
+                           double imbalance,
+                           const json* jLinkProfiles)
+{
+    NS_ASSERT(parts >= 1);
+
+    std::unordered_map<uint32_t, uint32_t> index;
+    std::vector<uint32_t> nodeIds;
+    for (const auto& jNode : jNodes)
+    {
+        uint32_t nodeId = jNode.at("nodeId").get<uint32_t>();
+        index.emplace(nodeId, nodeIds.size());
+        nodeIds.push_back(nodeId);
+    }
+    const uint32_t n = nodeIds.size();
+    auto indexOf = [&](uint32_t nodeId) {
+        auto it = index.find(nodeId);
+        if (it == index.end())
+            throw std::invalid_argument("Link references unknown node: " + std::to_string(nodeId));
+        return it->second;
+    };
+
+    /* ---------- 收缩不可切开的链路 ---------- */
+    UnionFind uf(n);
+    Time minDelay = Time::Max();
+    for (const auto& jLink : jLinks)
+    {
+        std::vector<uint32_t> ids = EndpointIds(jLink);
+        if (IsCuttable(jLink, jLinkProfiles))
+        {
+            minDelay = std::min(minDelay, LinkDelay(jLink, jLinkProfiles));
+            continue;
+        }
+        for (std::size_t i = 1; i < ids.size(); ++i)
+            uf.Union(indexOf(ids[0]), indexOf(ids[i]));
+    }
+
+    std::vector<uint32_t> superOf(n);
+    std::vector<int32_t> superIndex(n, -1);
+    PartitionGraph g;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t root = uf.Find(i);
+        if (superIndex[root] < 0)
+        {
+            superIndex[root] = g.weight.size();
+            g.weight.push_back(0);
+        }
+        superOf[i] = superIndex[root];
+        g.weight[superOf[i]]++;
+    }
+    g.adj.resize(g.weight.size());
+
+    /* ---------- p2p 边：时延越小代价越大 ---------- */
+    std::vector<std::unordered_map<uint32_t, double>> edges(g.weight.size());
+    for (const auto& jLink : jLinks)
+    {
+        if (!IsCuttable(jLink, jLinkProfiles))
+            continue;
+        std::vector<uint32_t> ids = EndpointIds(jLink);
+        uint32_t a = superOf[indexOf(ids[0])];
+        uint32_t b = superOf[indexOf(ids[1])];
+        if (a == b)
+            continue;
+        double w = minDelay.GetDouble() / LinkDelay(jLink, jLinkProfiles).GetDouble();
+        edges[a][b] += w;
+        edges[b][a] += w;
+    }
+    for (uint32_t v = 0; v < edges.size(); ++v)
+    {
+        g.adj[v].assign(edges[v].begin(), edges[v].end());
+        // 固定顺序，保证各 rank 计算结果一致
+        std::sort(g.adj[v].begin(), g.adj[v].end());
+    }
+
+    std::vector<uint32_t> vertices(g.weight.size());
+    std::iota(vertices.begin(), vertices.end(), 0);
+    std::vector<int32_t> local(g.weight.size(), -1);
+    std::vector<uint32_t> superPart(g.weight.size(), 0);
+    PartitionRecursive(g, vertices, parts, 0, imbalance, local, superPart);
+
+    std::unordered_map<uint32_t, uint32_t> systemIds;
+    for (uint32_t i = 0; i < n; ++i)
+        systemIds.emplace(nodeIds[i], superPart[superOf[i]]);
+    return systemIds;
+}
+
+TopologyPartition::TopologyPartition(std::unordered_map<uint32_t, uint32_t> systemIds,
+                                     const json& jLinks,
+                                     uint32_t rank,
+                                     uint32_t size,
+                                     bool fullTopology,
+                                     const json* jLinkProfiles)
+    : m_systemIds(std::move(systemIds)),
+      m_rank(rank),
+      m_size(size),
+      m_fullTopology(fullTopology)
+{
+    /* ---------- 切边与边界节点：与 owned 节点 p2p 相连的远端节点 ---------- */
+    for (const auto& jLink : jLinks)
+    {
+        std::vector<uint32_t> ids = EndpointIds(jLink);
+        bool cut = false;
+        bool owned = false;
+        for (uint32_t id : ids)
+        {
+            cut |= GetSystemId(id) != GetSystemId(ids[0]);
+            owned |= IsNodeOwned(id);
+        }
+        if (owned || m_fullTopology)
+            m_links.insert(jLink.at("linkId").get<uint32_t>());
+        if (!cut)
+            continue;
+        if (!IsCuttable(jLink, jLinkProfiles))
+        {
+            throw std::invalid_argument("Link " + std::to_string(jLink.at("linkId").get<uint32_t>()) +
+                                        " spans several systemIds but is not a p2p link with "
+                                        "positive delay");
+        }
+        m_lookahead = std::min(m_lookahead, LinkDelay(jLink, jLinkProfiles));
+        if (owned && !m_fullTopology)
+        {
+            for (uint32_t id : ids)
+                if (!IsNodeOwned(id))
+                    m_boundary.insert(id);
+        }
+    }
+}
+
+uint32_t
+TopologyPartition::GetRank() const
+{
+    return m_rank;
+}
+
+uint32_t
+TopologyPartition::GetSize() const
+{
+    return m_size;
+}
+
+uint32_t
+TopologyPartition::GetSystemId(uint32_t nodeId) const
+{
+    auto it = m_systemIds.find(nodeId);
+    if (it == m_systemIds.end())
+        throw std::invalid_argument("Unknown node: " + std::to_string(nodeId));
+    return it->second;
+}
+
+Time
+TopologyPartition::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+bool
+TopologyPartition::IsNodeOwned(uint32_t nodeId) const
+{
+    return GetSystemId(nodeId) == m_rank;
+}
+
+bool
+TopologyPartition::IsNodeInstalled(uint32_t nodeId) const
+{
+    return m_fullTopology || IsNodeOwned(nodeId);
+}
+
+bool
+TopologyPartition::IsLinkInstalled(uint32_t linkId) const
+{
+    return m_links.count(linkId) > 0;
+}
+
+bool
+TopologyPartition::IsBoundaryNode(uint32_t nodeId) const
+{
+    return m_boundary.count(nodeId) > 0;
+}
+
+/* ===============================
+ * TopologySubset
+ * =============================== */
+TopologySubset::TopologySubset(const json& jSubset, const json& jNodes, const json& jLinks)
+{
+    /* ---------- nodeId / 区间 ---------- */
+    // 区间不逐个展开，只选 nodes.json 中落在区间内的节点：过大的区间不会占用内存
+    if (jSubset.contains("nodes"))
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+        for (const auto& j : jSubset.at("nodes"))
+        {
+            if (j.is_array())
+            {
+                const uint32_t first = j.at(0).get<uint32_t>();
+                const uint32_t last = j.at(1).get<uint32_t>();
+                if (first > last)
+                    throw std::invalid_argument("subset.nodes: reversed range [" +
+                                                std::to_string(first) + ", " +
+                                                std::to_string(last) + "]");
+                ranges.emplace_back(first, last);
+            }
+            else
+                m_nodes.insert(j.get<uint32_t>());
+        }
+        if (!ranges.empty())
+        {
+            for (const auto& jNode : jNodes)
+            {
+                const uint32_t id = jNode.at("nodeId").get<uint32_t>();
+                for (const auto& [first, last] : ranges)
+                {
+                    if (id >= first && id <= last)
+                    {
+                        m_nodes.insert(id);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /* ---------- role ---------- */
+    if (jSubset.contains("roles"))
+    {
+        const auto roles = jSubset.at("roles").get<std::unordered_set<std::string>>();
+        for (const auto& jNode : jNodes)
+        {
+            if (jNode.contains("role") && roles.count(jNode.at("role").get<std::string>()))
+                m_nodes.insert(jNode.at("nodeId").get<uint32_t>());
+        }
+    }
+
+    /* ---------- k 跳邻域：同一链路（含共享信道）的端点互为一跳 ---------- */
+    if (jSubset.contains("around"))
+    {
+        const auto& jAround = jSubset.at("around");
+        const uint32_t hops = jAround.value("hops", 1u);
+
+        // 节点 -> 所在链路；BFS 中每条链路只展开一次，避免大 wifi 链路的端点两两连边
+        std::vector<std::vector<uint32_t>> linkEnds;
+        std::unordered_map<uint32_t, std::vector<std::size_t>> nodeLinks;
+        for (const auto& jLink : jLinks)
+        {
+            linkEnds.push_back(EndpointIds(jLink));
+            for (uint32_t id : linkEnds.back())
+                nodeLinks[id].push_back(linkEnds.size() - 1);
+        }
+
+        std::unordered_map<uint32_t, uint32_t> dist;
+        std::vector<bool> expanded(linkEnds.size(), false);
+        std::queue<uint32_t> frontier;
+        for (const auto& j : jAround.at("nodes"))
+        {
+            const uint32_t id = j.get<uint32_t>();
+            if (dist.emplace(id, 0).second)
+                frontier.push(id);
+        }
+        while (!frontier.empty())
+        {
+            const uint32_t v = frontier.front();
+            frontier.pop();
+            m_nodes.insert(v);
+            const uint32_t d = dist[v];
+            if (d == hops)
+                continue;
+            for (std::size_t l : nodeLinks[v])
+            {
+                if (expanded[l])
+                    continue;
+                expanded[l] = true;
+                for (uint32_t u : linkEnds[l])
+                {
+                    if (dist.emplace(u, d + 1).second)
+                        frontier.push(u);
+                }
+            }
+        }
+    }
+
+    /* ---------- 只连接选中节点的链路 ---------- */
+    for (const auto& jLink : jLinks)
+    {
+        bool inside = true;
+        for (uint32_t id : EndpointIds(jLink))
+            inside &= ContainsNode(id);
+        if (inside)
+            m_links.insert(jLink.at("linkId").get<uint32_t>());
+    }
+}
+
+bool
+TopologySubset::ContainsNode(uint32_t nodeId) const
+{
+    return m_nodes.count(nodeId) > 0;
+}
+
+bool
+TopologySubset::ContainsLink(uint32_t linkId) const
+{
+    return m_links.count(linkId) > 0;
+}
+
+std::size_t
+TopologySubset::GetNNodes() const
+{
+    return m_nodes.size();
+}
+
+std::size_t
+TopologySubset::GetNLinks() const
+{
+    return m_links.size();
+}
+
+/* ===============================
+ * SwitchedSegments
+ * =============================== */
+SwitchedSegments::SwitchedSegments(const json& jNodes,
+                                   const json& jLinks,
+                                   const std::function<bool(uint32_t)>& isLinkInstalled)
+{
+    std::unordered_set<uint32_t> switches;
+    for (const auto& jNode : jNodes)
+    {
+        if (jNode.value("role", "") == "switch")
+            switches.insert(jNode.at("nodeId").get<uint32_t>());
+    }
+
+    // 交换机 -> 连接它的链路；不满足条件的交换机记为不可合并
+    std::unordered_map<uint32_t, std::vector<const json*>> attached;
+    std::unordered_set<uint32_t> rejected;
+    for (const auto& jLink : jLinks)
+    {
+        const std::vector<uint32_t> ids = EndpointIds(jLink);
+        for (uint32_t id : ids)
+        {
+            if (!switches.count(id))
+                continue;
+            attached[id].push_back(&jLink);
+            const bool csmaPair = jLink.at("type").get<std::string>() == "csma" && ids.size() == 2;
+            if (!csmaPair)
+            {
+                rejected.insert(id);
+                continue;
+            }
+            // 只有两个端点时才有“另一端”
+            const uint32_t other = ids[0] == id ? ids[1] : ids[0];
+            if (switches.count(other) || !isLinkInstalled(jLink.at("linkId").get<uint32_t>()))
+                rejected.insert(id);
+        }
+    }
+
+    static const json kNone;
+    auto block = [](const json& jLink, const char* key) -> const json& {
+        return jLink.contains(key) ? jLink.at(key) : kNone;
+    };
+
+    std::vector<uint32_t> order;
+    for (const auto& [id, links] : attached)
+        order.push_back(id);
+    std::sort(order.begin(), order.end());
+
+    for (uint32_t id : order)
+    {
+        const auto& links = attached.at(id);
+        if (rejected.count(id) || links.size() < 2)
+            continue;
+
+        Segment segment{id, links.front()->at("linkId").get<uint32_t>(), {}};
+        std::unordered_set<uint32_t> seen;
+        bool ok = true;
+        for (const json* jLink : links)
+        {
+            // 合并后只有一组信道 / 设备 / 队列属性
+            for (const char* key : {"channel", "device", "queue"})
+                ok &= block(*jLink, key) == block(*links.front(), key);
+
+            const std::vector<uint32_t> ids = EndpointIds(*jLink);
+            const uint32_t other = ids[0] == id ? ids[1] : ids[0];
+            ok &= seen.insert(other).second;
+            segment.endpoints.emplace_back(other, jLink->at("linkId").get<uint32_t>());
+        }
+        if (!ok)
+            continue;
+
+        for (const auto& [nodeId, linkId] : segment.endpoints)
+            m_byLink.emplace(linkId, m_segments.size());
+        m_switches.insert(id);
+        m_segments.push_back(std::move(segment));
+    }
+}
+
+const SwitchedSegments::Segment*
+SwitchedSegments::FindByLink(uint32_t linkId) const
+{
+    auto it = m_byLink.find(linkId);
+    return it == m_byLink.end() ? nullptr : &m_segments[it->second];
+}
+
+bool
+SwitchedSegments::IsCollapsed(uint32_t nodeId) const
+{
+    return m_switches.count(nodeId) > 0;
+}
+
+std::size_t
+SwitchedSegments::GetNSegments() const
+{
+    return m_segments.size();
+}
+
+/* ===============================
+ * MPI entry
+ * =============================== */
+std::unique_ptr<TopologyPartition>
+CreateMpiPartition(const json& jConfig,
+                   const json& jNodes,
+                   const json& jLinks,
+                   bool fullTopology)
+{
+    uint32_t rank = 0;
+    uint32_t size = 1;
+#ifdef NS3_MPI
+    if (MpiInterface::IsEnabled())
+    {
+        rank = MpiInterface::GetSystemId();
+        size = MpiInterface::GetSize();
+    }
+#endif
+    if (size <= 1)
+    {
+        if (jConfig.contains("distributed"))
+            NS_LOG_WARN("\"distributed\" is set but MPI is not enabled; installing sequentially");
+        return nullptr;
+    }
+
+    const json jDistributed = jConfig.value("distributed", json::object());
+    const json* jLinkProfiles = nullptr;
+    if (jConfig.contains("profiles") && jConfig.at("profiles").contains("link"))
+        jLinkProfiles = &jConfig.at("profiles").at("link");
+    const double imbalance = jDistributed.value("imbalance", 0.03);
+
+    std::unordered_map<uint32_t, uint32_t> systemIds;
+    bool pinned = !jNodes.empty();
+    for (const auto& jNode : jNodes)
+        pinned &= jNode.contains("systemId");
+
+    if (pinned)
+    {
+        for (const auto& jNode : jNodes)
+        {
+            uint32_t systemId = jNode.at("systemId").get<uint32_t>();
+            if (systemId >= size)
+                throw std::invalid_argument("systemId exceeds MPI size: " +
+                                            std::to_string(systemId));
+            systemIds.emplace(jNode.at("nodeId").get<uint32_t>(), systemId);
+        }
+    }
+    else
+    {
+        systemIds = TopologyPartition::Compute(jNodes, jLinks, size, imbalance, jLinkProfiles);
+    }
+
+    auto partition = std::make_unique<TopologyPartition>(std::move(systemIds),
+                                                         jLinks,
+                                                         rank,
+                                                         size,
+                                                         fullTopology,
+                                                         jLinkProfiles);
+
+    if (rank == 0)
+    {
+        std::vector<uint32_t> counts(size, 0);
+        for (const auto& jNode : jNodes)
+            counts[partition->GetSystemId(jNode.at("nodeId").get<uint32_t>())]++;
+        for (uint32_t r = 0; r < size; ++r)
+            NS_LOG_INFO("partition " << r << ": " << counts[r] << " nodes");
+        NS_LOG_INFO("lookahead (min cut p2p delay): " << partition->GetLookahead().As(Time::US));
+    }
+    return partition;
+}
+} // namespace configjson2
+} // namespace ns3
@@ -0,0 +1,159 @@
+/**
+ * @file config-json2-partition.h
+ * @brief Topology partitioning for distributed (MPI) installation, subset filtering and
+ *        switched-segment collapsing.
+ */
+
+#ifndef CONFIG_JSON_PARTITION_H
+#define CONFIG_JSON_PARTITION_H
+
+#include "config-json2-json.h"
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * 节点到 systemId（MPI rank）的映射，以及本 rank 需要安装的节点/链路集合。
+ *
+ * 划分：csma / wifi 等共享信道链路和零时延 p2p 链路先收缩成超节点（不可切开），
+ * 剩余 p2p 链路以 minDelay/delay 为边权做递归二分（贪心生长 + FM 细化），
+ * 使被切开的链路尽量是时延大的链路，从而增大分布式仿真的 lookahead。
+ *
+ * 成员关系：
+ * - owned：systemId == rank 的节点，安装协议栈、地址、路由、移动模型和应用；
+ * - 链路：至少一个端点是 owned 节点时安装，跨 rank 的 p2p 链路由 PointToPointHelper
+ *   自动使用 PointToPointRemoteChannel；
+ * - 边界节点：通过被切开的 p2p 链路与 owned 节点相连的远端节点。它在本 rank
+ *   未安装的链路上补一个占位 SimpleNetDevice，使其 ifIndex 与所属 rank 上一致
+ *   （MPI 按 NodeId + ifIndex 投递包）。
+ * 所有节点在每个 rank 上都创建（保持 NodeId 一致），其余节点只是空 Node。
+ * fullTopology（全局路由）时每个 rank 安装完整拓扑，只有应用按 owned 过滤。
+ */
+class TopologyPartition
+{
+  public:
+    // 返回 nodeId -> systemId；jLinkProfiles 为 config.json 的 profiles.link，
+    // 用于取引用 profile 的 p2p 链路的时延
+    static std::unordered_map<uint32_t, uint32_t> Compute(const json& jNodes,
+                                                          const json& jLinks,
+                                                          uint32_t parts,
+                                                          double imbalance,
+                                                          const json* jLinkProfiles = nullptr);
+
+    TopologyPartition(std::unordered_map<uint32_t, uint32_t> systemIds,
+                      const json& jLinks,
+                      uint32_t rank,
+                      uint32_t size,
+                      bool fullTopology,
+                      const json* jLinkProfiles = nullptr);
+
+    uint32_t GetRank() const;
+    uint32_t GetSize() const;
+    uint32_t GetSystemId(uint32_t nodeId) const;
+    // 被切开的 p2p 链路的最小时延；没有切边时为 Time::Max()
+    Time GetLookahead() const;
+
+    bool IsNodeOwned(uint32_t nodeId) const;
+    bool IsNodeInstalled(uint32_t nodeId) const;
+    bool IsLinkInstalled(uint32_t linkId) const;
+    bool IsBoundaryNode(uint32_t nodeId) const;
+
+  private:
+    std::unordered_map<uint32_t, uint32_t> m_systemIds;
+    std::unordered_set<uint32_t> m_links;
+    std::unordered_set<uint32_t> m_boundary;
+    uint32_t m_rank;
+    uint32_t m_size;
+    bool m_fullTopology;
+    Time m_lookahead = Time::Max();
+};
+
+/**
+ * 只安装拓扑的一部分，用于调试大模型中的一个区域。config.json 的 "subset"：
+ *
+ * "subset": {
+ *     "nodes": [5, [100, 199]],              // nodeId 或闭区间
+ *     "roles": ["router"],                    // nodes.json 中的 role
+ *     "around": {"nodes": [17], "hops": 2}    // 给定节点 hops 跳以内的节点
+ * }
+ *
+ * 选中的节点为三者的并集。链路的全部端点都被选中时才安装；地址、路由、移动模型和应用
+ * 经 ConfigJsonHelper 的 IsNodeInstalled / IsLinkInstalled 等判断随之过滤，
+ * 与 TopologyPartition 的成员关系叠加使用。
+ */
+class TopologySubset
+{
+  public:
+    TopologySubset(const json& jSubset, const json& jNodes, const json& jLinks);
+
+    bool ContainsNode(uint32_t nodeId) const;
+    bool ContainsLink(uint32_t linkId) const;
+    std::size_t GetNNodes() const;
+    std::size_t GetNLinks() const;
+
+  private:
+    std::unordered_set<uint32_t> m_nodes;
+    std::unordered_set<uint32_t> m_links;
+};
+
+/**
+ * config.json 的 "collapseSwitches" 选中的交换段：一个 role 为 switch 的节点及其 csma 链路
+ * 合并为一条直接连接各端点的 csma 信道，交换机不再有设备和网桥。
+ *
+ * 只在以下条件都满足时合并，否则该交换机照常桥接：
+ * - 交换机的链路都是恰好两个端点的 csma 链路，至少两条，且 channel / device / queue 块相同；
+ * - 另一端不是交换机，同一端点不经两条链路连到该交换机；
+ * - 各链路都在本进程安装（子集 / 划分）。
+ *
+ * 端点的设备仍按原链路命名为 node<n>-link<l>，各原链路的 link<l>-channel 都指向合并后的信道。
+ */
+class SwitchedSegments
+{
+  public:
+    struct Segment
+    {
+        uint32_t switchNodeId;
+        uint32_t leaderLinkId; // links.json 中该段的第一条链路，安装整段
+        // (nodeId, 原 linkId)，按 links.json 顺序
+        std::vector<std::pair<uint32_t, uint32_t>> endpoints;
+    };
+
+    SwitchedSegments(const json& jNodes,
+                     const json& jLinks,
+                     const std::function<bool(uint32_t)>& isLinkInstalled);
+
+    // 链路所属的段，不属于任何段时为空指针
+    const Segment* FindByLink(uint32_t linkId) const;
+    // 交换机已被合并（没有设备）
+    bool IsCollapsed(uint32_t nodeId) const;
+    std::size_t GetNSegments() const;
+
+  private:
+    std::vector<Segment> m_segments;
+    std::unordered_map<uint32_t, std::size_t> m_byLink;
+    std::unordered_set<uint32_t> m_switches;
+};
+
+/**
+ * 根据 MPI 状态构造划分。MPI 未启用或只有一个进程时返回空指针（顺序安装）。
+ * nodes.json 中所有节点都给出 systemId 时直接使用，否则自动划分。
+ */
+std::unique_ptr<TopologyPartition> CreateMpiPartition(const json& jConfig,
+                                                      const json& jNodes,
+                                                      const json& jLinks,
+                                                      bool fullTopology);
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_PARTITION_H
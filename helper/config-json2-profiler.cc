@@ -0,0 +1,362 @@
+#include "config-json2-profiler.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <malloc.h>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace ns3
+{
+namespace configjson2
+{
+namespace
+{
+double
+ElapsedSeconds(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+bool
+EndsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+} // namespace
+
+/* ---------- Scope ---------- */
+InstallProfiler::Scope::Scope(InstallProfiler& profiler,
+                              const std::string& domain,
+                              const std::string& type)
+    : m_profiler(profiler),
+      m_domain(domain),
+      m_type(type),
+      m_wall(std::chrono::steady_clock::now()),
+      m_cpu(CpuSeconds()),
+      m_rss(ResidentBytes()),
+      m_heap(profiler.m_memory ? HeapBytes() : 0)
+{
+}
+
+InstallProfiler::Scope::~Scope()
+{
+    if (!m_profiler.m_inStage)
+        return;
+
+    ProfileSample& s = m_profiler.m_stages.back().handlers[m_domain][m_type];
+    s.count++;
+    s.wallSec += ElapsedSeconds(m_wall);
+    s.cpuSec += CpuSeconds() - m_cpu;
+    s.rssDeltaBytes += ResidentBytes() - m_rss;
+    if (m_profiler.m_memory)
+        s.heapDeltaBytes += HeapBytes() - m_heap;
+    m_profiler.m_stages.back().total.count++;
+}
+
+/* ---------- InstallProfiler ---------- */
+void
+InstallProfiler::Enable(const std::string& path, const std::string& format)
+{
+    if (format.empty())
+        m_csv = EndsWith(path, ".csv");
+    else if (format == "csv")
+        m_csv = true;
+    else if (format == "json")
+        m_csv = false;
+    else
+        throw std::invalid_argument("Unknown profile format: " + format);
+
+    m_path = path;
+    m_enabled = true;
+}
+
+bool
+InstallProfiler::IsEnabled() const
+{
+    return m_enabled;
+}
+
+void
+InstallProfiler::EnableMemory()
+{
+    m_memory = true;
+}
+
+bool
+InstallProfiler::IsMemoryEnabled() const
+{
+    return m_memory;
+}
+
+void
+InstallProfiler::BeginStage(const std::string& name)
+{
+    if (m_inStage)
+        EndStage();
+
+    Stage stage;
+    stage.name = name;
+    stage.rssBeginBytes = ResidentBytes();
+    stage.heapBeginBytes = m_memory ? HeapBytes() : 0;
+    m_stages.push_back(std::move(stage));
+    m_inStage = true;
+    m_stageWall = std::chrono::steady_clock::now();
+    m_stageCpu = CpuSeconds();
+}
+
+void
+InstallProfiler::EndStage()
+{
+    if (!m_inStage)
+        return;
+
+    Stage& stage = m_stages.back();
+    stage.total.wallSec = ElapsedSeconds(m_stageWall);
+    stage.total.cpuSec = CpuSeconds() - m_stageCpu;
+    stage.rssEndBytes = ResidentBytes();
+    stage.total.rssDeltaBytes = stage.rssEndBytes - stage.rssBeginBytes;
+    stage.heapEndBytes = m_memory ? HeapBytes() : 0;
+    stage.total.heapDeltaBytes = stage.heapEndBytes - stage.heapBeginBytes;
+    m_inStage = false;
+}
+
+void
+InstallProfiler::AddMemoryUnit(const std::string& name,
+                               uint64_t count,
+                               const std::vector<std::string>& stages)
+{
+    int64_t heap = 0;
+    for (const auto& stage : m_stages)
+    {
+        for (const auto& wanted : stages)
+        {
+            if (stage.name == wanted)
+                heap += stage.total.heapDeltaBytes;
+        }
+    }
+    m_units.push_back({name, count, heap});
+}
+
+void
+InstallProfiler::AddObjectType(const std::string& type, uint64_t count)
+{
+    m_objectTypes[type] += count;
+}
+
+void
+InstallProfiler::AddRetainedJson(const std::string& domain,
+                                 uint64_t heldValues,
+                                 uint64_t heldBytes,
+                                 uint64_t arenaBytes,
+                                 uint64_t values,
+                                 uint64_t bytes)
+{
+    m_retained.push_back({domain, heldValues, heldBytes, arenaBytes, values, bytes});
+}
+
+const std::string&
+InstallProfiler::GetPath() const
+{
+    return m_path;
+}
+
+void
+InstallProfiler::Write(const std::string& path) const
+{
+    if (!m_enabled)
+        return;
+
+    std::ofstream ofs(path);
+    if (!ofs.is_open())
+    {
+        throw std::runtime_error("InstallProfiler: cannot open report file: " + path);
+    }
+    ofs << std::setprecision(9);
+    if (m_csv)
+        WriteCsv(ofs);
+    else
+        WriteJson(ofs);
+}
+
+void
+InstallProfiler::WriteJson(std::ostream& os) const
+{
+    ProfileSample total;
+    for (const auto& stage : m_stages)
+    {
+        total.count += stage.total.count;
+        total.wallSec += stage.total.wallSec;
+        total.cpuSec += stage.total.cpuSec;
+        total.rssDeltaBytes += stage.total.rssDeltaBytes;
+        total.heapDeltaBytes += stage.total.heapDeltaBytes;
+    }
+
+    os << "{\n  \"wallSec\": " << total.wallSec << ",\n  \"cpuSec\": " << total.cpuSec
+       << ",\n  \"rssDeltaBytes\": " << total.rssDeltaBytes
+       << ",\n  \"rssBytes\": " << ResidentBytes()
+       << ",\n  \"peakRssBytes\": " << PeakResidentBytes()
+       << ",\n  \"heapDeltaBytes\": " << total.heapDeltaBytes
+       << ",\n  \"heapBytes\": " << (m_memory ? HeapBytes() : 0) << ",\n  \"stages\": [";
+
+    for (std::size_t i = 0; i < m_stages.size(); ++i)
+    {
+        const Stage& stage = m_stages[i];
+        os << (i ? "," : "") << "\n    {\"name\": \"" << stage.name
+           << "\", \"elements\": " << stage.total.count << ", \"wallSec\": " << stage.total.wallSec
+           << ", \"cpuSec\": " << stage.total.cpuSec << ", \"rssBeginBytes\": " << stage.rssBeginBytes
+           << ", \"rssEndBytes\": " << stage.rssEndBytes
+           << ", \"rssDeltaBytes\": " << stage.total.rssDeltaBytes
+           << ", \"heapDeltaBytes\": " << stage.total.heapDeltaBytes << ", \"handlers\": [";
+
+        bool first = true;
+        for (const auto& [domain, types] : stage.handlers)
+        {
+            for (const auto& [type, s] : types)
+            {
+                os << (first ? "" : ",") << "\n      {\"domain\": \"" << domain << "\", \"type\": \""
+                   << type << "\", \"calls\": " << s.count << ", \"wallSec\": " << s.wallSec
+                   << ", \"cpuSec\": " << s.cpuSec << ", \"rssDeltaBytes\": " << s.rssDeltaBytes
+                   << ", \"heapDeltaBytes\": " << s.heapDeltaBytes << "}";
+                first = false;
+            }
+        }
+        os << (first ? "" : "\n    ") << "]}";
+    }
+    os << "\n  ]";
+
+    if (m_memory)
+    {
+        os << ",\n  \"memory\": {\n    \"units\": [";
+        for (std::size_t i = 0; i < m_units.size(); ++i)
+        {
+            const MemoryUnit& u = m_units[i];
+            os << (i ? "," : "") << "\n      {\"name\": \"" << u.name
+               << "\", \"count\": " << u.count << ", \"heapBytes\": " << u.heapBytes
+               << ", \"bytesPerUnit\": " << (u.count ? double(u.heapBytes) / u.count : 0.0) << "}";
+        }
+        os << "\n    ],\n    \"objectTypes\": [";
+        bool first = true;
+        for (const auto& [type, count] : m_objectTypes)
+        {
+            os << (first ? "" : ",") << "\n      {\"type\": \"" << type
+               << "\", \"count\": " << count << "}";
+            first = false;
+        }
+        os << "\n    ],\n    \"retainedJson\": [";
+        for (std::size_t i = 0; i < m_retained.size(); ++i)
+        {
+            const RetainedJson& r = m_retained[i];
+            os << (i ? "," : "") << "\n      {\"domain\": \"" << r.domain
+               << "\", \"heldValues\": " << r.heldValues << ", \"heldBytes\": " << r.heldBytes
+               << ", \"arenaBytes\": " << r.arenaBytes << ", \"values\": " << r.values
+               << ", \"bytes\": " << r.bytes << "}";
+        }
+        os << "\n    ]\n  }";
+    }
+    os << "\n}\n";
+}
+
+void
+InstallProfiler::WriteCsv(std::ostream& os) const
+{
+    // stage 行的 domain/type 为空；handler 行的 count 为调用次数
+    os << "stage,domain,type,count,wallSec,cpuSec,rssDeltaBytes,heapDeltaBytes\n";
+    for (const auto& stage : m_stages)
+    {
+        os << '"' << stage.name << "\",,," << stage.total.count << ',' << stage.total.wallSec << ','
+           << stage.total.cpuSec << ',' << stage.total.rssDeltaBytes << ','
+           << stage.total.heapDeltaBytes << '\n';
+        for (const auto& [domain, types] : stage.handlers)
+        {
+            for (const auto& [type, s] : types)
+            {
+                os << '"' << stage.name << "\"," << domain << ',' << type << ',' << s.count << ','
+                   << s.wallSec << ',' << s.cpuSec << ',' << s.rssDeltaBytes << ','
+                   << s.heapDeltaBytes << '\n';
+            }
+        }
+    }
+
+    // 内存统计行的 stage 为 Memory，domain 为 unit | object | json-held | json-arena | json，
+    // 字节数放在 heapDeltaBytes 列；json-held / json-arena 为安装期间持有的，json 为 Install 后仍保留的
+    if (!m_memory)
+        return;
+    for (const auto& u : m_units)
+        os << "Memory,unit," << u.name << ',' << u.count << ",,,," << u.heapBytes << '\n';
+    for (const auto& [type, count] : m_objectTypes)
+        os << "Memory,object," << type << ',' << count << ",,,,\n";
+    for (const auto& r : m_retained)
+    {
+        os << "Memory,json-held," << r.domain << ',' << r.heldValues << ",,,," << r.heldBytes
+           << '\n';
+        os << "Memory,json-arena," << r.domain << ",,,,," << r.arenaBytes << '\n';
+        os << "Memory,json," << r.domain << ',' << r.values << ",,,," << r.bytes << '\n';
+    }
+}
+
+double
+InstallProfiler::CpuSeconds()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int64_t
+InstallProfiler::ResidentBytes()
+{
+    // /proc/self/statm 第二列为常驻页数；保持 fd 打开，每次 pread，避免逐次 open。
+    // /proc/self 在 open 时解析，fork 后子进程需要重新打开
+    static const int64_t pageSize = sysconf(_SC_PAGESIZE);
+    static int fd = -1;
+    static pid_t owner = 0;
+    if (owner != getpid())
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+        owner = getpid();
+    }
+    if (fd < 0)
+        return 0;
+
+    char buf[128];
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0)
+        return 0;
+    buf[n] = '\0';
+
+    long long size = 0;
+    long long resident = 0;
+    if (std::sscanf(buf, "%lld %lld", &size, &resident) != 2)
+        return 0;
+    return resident * pageSize;
+}
+
+int64_t
+InstallProfiler::PeakResidentBytes()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+}
+
+int64_t
+InstallProfiler::HeapBytes()
+{
+    // mallinfo2 汇总全部 arena：uordblks 为 brk 堆在用字节，hblkhd 为 mmap 分配的大块
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#else
+    return 0;
+#endif
+}
+} // namespace configjson2
+} // namespace ns3
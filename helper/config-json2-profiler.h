@@ -0,0 +1,144 @@
+/**
+ * @file config-json2-profiler.h
+ * @brief Per-stage / per-handler install profiler.
+ */
+
+#ifndef CONFIG_JSON_PROFILER_H
+#define CONFIG_JSON_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+// 一段被测代码的累计开销
+struct ProfileSample
+{
+    uint64_t count = 0;
+    double wallSec = 0;
+    double cpuSec = 0;
+    int64_t rssDeltaBytes = 0;
+    int64_t heapDeltaBytes = 0;
+};
+
+/**
+ * Install 阶段性能剖析。
+ *
+ * 每个阶段记录墙钟时间、进程 CPU 时间、常驻内存 (RSS) 变化和处理的元素数，
+ * 阶段内按 domain/type 汇总每种 HandlerFn 的调用次数和耗时。
+ * 阶段计时始终开启（每阶段两次采样），handler 计时只在 Enable() 之后进行。
+ * handler 时间为包含时间：嵌套的 Scope 会被外层重复计入。
+ *
+ * EnableMemory() 后额外在每个阶段和每次 handler 调用前后采样 malloc 的在用字节数，
+ * 并输出 AddMemoryUnit / AddObjectType / AddRetainedJson 登记的内存统计。
+ */
+class InstallProfiler
+{
+  public:
+    // RAII：构造时开始计时，析构时累加到当前阶段的 domain/type 条目
+    class Scope
+    {
+      public:
+        Scope(InstallProfiler& profiler, const std::string& domain, const std::string& type);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        InstallProfiler& m_profiler;
+        const std::string& m_domain;
+        const std::string& m_type;
+        std::chrono::steady_clock::time_point m_wall;
+        double m_cpu;
+        int64_t m_rss;
+        int64_t m_heap;
+    };
+
+    // format 为 json 或 csv；为空时按文件扩展名判断
+    void Enable(const std::string& path, const std::string& format = "");
+    bool IsEnabled() const;
+    void EnableMemory();
+    bool IsMemoryEnabled() const;
+
+    void BeginStage(const std::string& name);
+    void EndStage();
+
+    // 一类对象的数量，堆增长取所列阶段 heapDeltaBytes 之和
+    void AddMemoryUnit(const std::string& name,
+                       uint64_t count,
+                       const std::vector<std::string>& stages);
+    // 安装后存在的 ns-3 对象个数，按 TypeId 名
+    void AddObjectType(const std::string& type, uint64_t count);
+    // 一个 domain 的 JSON：安装期间持有的（释放前测量）和 Install 后仍保留的值个数、估算字节数，
+    // arenaBytes 为安装期间该 domain 的 arena 向系统申请的字节数
+    void AddRetainedJson(const std::string& domain,
+                         uint64_t heldValues,
+                         uint64_t heldBytes,
+                         uint64_t arenaBytes,
+                         uint64_t values,
+                         uint64_t bytes);
+
+    const std::string& GetPath() const;
+    // 写出报告，未开启时什么也不做
+    void Write(const std::string& path) const;
+
+    static double CpuSeconds();
+    static int64_t ResidentBytes();
+    static int64_t PeakResidentBytes();
+    // malloc 在用字节数（glibc mallinfo2），不支持时为 0
+    static int64_t HeapBytes();
+
+  private:
+    struct Stage
+    {
+        std::string name;
+        ProfileSample total;
+        int64_t rssBeginBytes = 0;
+        int64_t rssEndBytes = 0;
+        int64_t heapBeginBytes = 0;
+        int64_t heapEndBytes = 0;
+        std::map<std::string, std::map<std::string, ProfileSample>> handlers;
+    };
+
+    struct MemoryUnit
+    {
+        std::string name;
+        uint64_t count;
+        int64_t heapBytes;
+    };
+
+    struct RetainedJson
+    {
+        std::string domain;
+        uint64_t heldValues;
+        uint64_t heldBytes;
+        uint64_t arenaBytes;
+        uint64_t values;
+        uint64_t bytes;
+    };
+
+    void WriteJson(std::ostream& os) const;
+    void WriteCsv(std::ostream& os) const;
+
+    bool m_enabled = false;
+    bool m_csv = false;
+    bool m_memory = false;
+    std::string m_path;
+    std::vector<Stage> m_stages;
+    bool m_inStage = false;
+    std::chrono::steady_clock::time_point m_stageWall;
+    double m_stageCpu = 0;
+    std::vector<MemoryUnit> m_units;
+    std::map<std::string, uint64_t> m_objectTypes;
+    std::vector<RetainedJson> m_retained;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_PROFILER_H
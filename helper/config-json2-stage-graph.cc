@@ -0,0 +1,332 @@
+#include "config-json2-stage-graph.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2StageGraph");
+
+// 固定数量的工作线程，执行队列中的任务直到析构
+class StageGraph::Pool
+{
+  public:
+    explicit Pool(uint32_t threads)
+    {
+        for (uint32_t t = 0; t < threads; ++t)
+            m_workers.emplace_back([this] { Work(); });
+    }
+
+    // install 抛出异常时也要停下工作线程：已开始的任务执行完，未开始的丢弃
+    ~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.clear();
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& w : m_workers)
+            w.join();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    std::size_t Size() const
+    {
+        return m_workers.size();
+    }
+
+    // front 为 true 时插队，用于当前正在等待的分块任务
+    void Push(std::function<void()> task, bool front = false)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (front)
+                m_queue.push_front(std::move(task));
+            else
+                m_queue.push_back(std::move(task));
+        }
+        m_cv.notify_one();
+    }
+
+  private:
+    void Work()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+                if (m_stop)
+                    return;
+                task = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::deque<std::function<void()>> m_queue;
+    bool m_stop = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::thread> m_workers;
+};
+
+void
+StageGraph::Add(Stage stage)
+{
+    if (Contains(stage.name))
+        throw std::invalid_argument("Duplicate install stage: " + stage.name);
+    m_stages.push_back(std::move(stage));
+}
+
+bool
+StageGraph::Contains(const std::string& name) const
+{
+    for (const auto& stage : m_stages)
+    {
+        if (stage.name == name)
+            return true;
+    }
+    return false;
+}
+
+std::vector<std::size_t>
+StageGraph::Order() const
+{
+    std::map<std::string, std::size_t> index;
+    for (std::size_t i = 0; i < m_stages.size(); ++i)
+        index[m_stages[i].name] = i;
+
+    std::vector<uint32_t> pending(m_stages.size(), 0);
+    std::vector<std::vector<std::size_t>> next(m_stages.size());
+    for (std::size_t i = 0; i < m_stages.size(); ++i)
+    {
+        for (const auto& dep : m_stages[i].after)
+        {
+            auto it = index.find(dep);
+            if (it == index.end())
+            {
+                throw std::invalid_argument("Install stage '" + m_stages[i].name +
+                                            "' depends on unknown stage '" + dep + "'");
+            }
+            next[it->second].push_back(i);
+            pending[i]++;
+        }
+    }
+
+    // Kahn：每次取添加顺序最靠前的就绪阶段，结果与线程数无关
+    std::vector<std::size_t> order;
+    std::vector<bool> taken(m_stages.size(), false);
+    while (order.size() < m_stages.size())
+    {
+        std::size_t pick = m_stages.size();
+        for (std::size_t i = 0; i < m_stages.size(); ++i)
+        {
+            if (!taken[i] && pending[i] == 0)
+            {
+                pick = i;
+                break;
+            }
+        }
+        if (pick == m_stages.size())
+        {
+            std::string cycle;
+            for (std::size_t i = 0; i < m_stages.size(); ++i)
+            {
+                if (!taken[i])
+                    cycle += (cycle.empty() ? "" : ", ") + m_stages[i].name;
+            }
+            throw std::invalid_argument("Install stages form a cycle: " + cycle);
+        }
+        taken[pick] = true;
+        order.push_back(pick);
+        for (std::size_t n : next[pick])
+            pending[n]--;
+    }
+    return order;
+}
+
+void
+StageGraph::Run(uint32_t threads,
+                InstallProfiler& profiler,
+                const std::function<void(const std::string&)>& release)
+{
+    const auto order = Order();
+
+    // 按拓扑序下标：该阶段 install 之后可释放的数据
+    std::vector<std::vector<std::string>> releaseAfter(order.size());
+    if (release)
+    {
+        std::map<std::string, std::size_t> lastReader;
+        for (std::size_t k = 0; k < order.size(); ++k)
+        {
+            for (const auto& data : m_stages[order[k]].reads)
+                lastReader[data] = k;
+        }
+        for (const auto& [data, k] : lastReader)
+            releaseAfter[k].push_back(data);
+    }
+    auto finish = [&](std::size_t k) {
+        for (const auto& data : releaseAfter[k])
+        {
+            NS_LOG_LOGIC("Release " << data << " after stage " << m_stages[order[k]].name);
+            release(data);
+        }
+    };
+
+    if (threads == 0)
+    {
+        for (std::size_t k = 0; k < order.size(); ++k)
+        {
+            Stage& stage = m_stages[order[k]];
+            NS_LOG_LOGIC("Install stage: " << stage.name);
+            profiler.BeginStage(stage.name);
+            if (stage.prepare)
+                stage.prepare();
+            if (stage.install)
+                stage.install();
+            finish(k);
+        }
+        return;
+    }
+
+    // 各阶段 prepare 的完成标志和异常，按拓扑序下标
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<bool> done(order.size(), false);
+    std::vector<std::exception_ptr> errors(order.size());
+
+    Pool pool(threads);
+    m_pool = &pool;
+    struct Reset
+    {
+        Pool*& pool;
+        ~Reset()
+        {
+            pool = nullptr;
+        }
+    } reset{m_pool};
+
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        pool.Push([&, k] {
+            std::exception_ptr error;
+            try
+            {
+                if (m_stages[order[k]].prepare)
+                    m_stages[order[k]].prepare();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done[k] = true;
+                errors[k] = error;
+            }
+            cv.notify_all();
+        });
+    }
+
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        Stage& stage = m_stages[order[k]];
+        NS_LOG_LOGIC("Install stage: " << stage.name);
+        profiler.BeginStage(stage.name);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return done[k]; });
+            if (errors[k])
+                std::rethrow_exception(errors[k]);
+        }
+        if (stage.install)
+            stage.install();
+        finish(k);
+    }
+}
+
+void
+StageGraph::ParallelFor(std::size_t n, const std::function<void(std::size_t, std::size_t)>& fn)
+{
+    // 每块至少这么多元素，避免调度开销超过工作本身
+    constexpr std::size_t kMinChunk = 256;
+
+    const std::size_t workers = m_pool ? m_pool->Size() : 0;
+    if (n == 0)
+        return;
+    if (workers == 0 || n <= kMinChunk)
+    {
+        fn(0, n);
+        return;
+    }
+
+    struct Batch
+    {
+        std::atomic<std::size_t> next{0};
+        std::size_t chunks = 0;
+        std::size_t chunkSize = 0;
+        std::size_t finished = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->chunkSize = std::max(kMinChunk, n / ((workers + 1) * 4) + 1);
+    batch->chunks = (n + batch->chunkSize - 1) / batch->chunkSize;
+
+    // 分块取完后才出队的辅助任务只读 batch->next 便返回，不再访问 fn
+    auto run = [batch, &fn, n] {
+        for (;;)
+        {
+            const std::size_t c = batch->next++;
+            if (c >= batch->chunks)
+                return;
+            std::exception_ptr error;
+            try
+            {
+                fn(c * batch->chunkSize, std::min(n, (c + 1) * batch->chunkSize));
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (error && !batch->error)
+                    batch->error = error;
+                batch->finished++;
+            }
+            batch->cv.notify_all();
+        }
+    };
+
+    for (std::size_t i = 0; i + 1 < std::min(workers + 1, batch->chunks); ++i)
+        m_pool->Push(run, true);
+    run();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->cv.wait(lock, [&] { return batch->finished == batch->chunks; });
+    if (batch->error)
+        std::rethrow_exception(batch->error);
+}
+} // namespace configjson2
+} // namespace ns3
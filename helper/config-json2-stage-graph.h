@@ -0,0 +1,76 @@
+/**
+ * @file config-json2-stage-graph.h
+ * @brief Install stages as a dependency graph with prepare work on worker threads.
+ */
+
+#ifndef CONFIG_JSON_STAGE_GRAPH_H
+#define CONFIG_JSON_STAGE_GRAPH_H
+
+#include "config-json2-profiler.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * Install 阶段依赖图。
+ *
+ * 每个阶段分两步：
+ * - prepare：只读 handleJson 和 handler 注册表，解析元素、查找 handler、按分区过滤，
+ *   生成本阶段的工作表；不得创建 ns-3 对象，在工作线程上执行
+ * - install：调用 handler 创建 ns-3 对象，在调用 Run() 的线程上执行
+ *
+ * install 按依赖的拓扑序串行执行，无依赖关系的阶段保持添加顺序，
+ * 因此对象创建顺序（以及自动分配的随机数流）与线程数无关、每次相同。
+ * prepare 互不依赖，全部提交给工作线程并按拓扑序排队，
+ * 主线程安装前面的阶段时，后面阶段的 prepare 已在并行进行。
+ * prepare 内可用 ParallelFor 把逐元素的工作（如两段式 handler 的 decode）分块交给线程池。
+ * 阶段在 reads 中声明读取的数据，最后一个读取者的 install 完成后回调 release，
+ * 此时其余阶段的 prepare 和 install 都不会再访问它。
+ */
+class StageGraph
+{
+  public:
+    struct Stage
+    {
+        std::string name;
+        // 必须先完成 install 的阶段
+        std::vector<std::string> after;
+        std::function<void()> prepare;
+        std::function<void()> install;
+        // prepare / install（含其调用的 handler）读取的数据名，如 domain 名
+        std::vector<std::string> reads;
+    };
+
+    void Add(Stage stage);
+    bool Contains(const std::string& name) const;
+
+    // 依赖的阶段不存在或有环时抛出 invalid_argument
+    std::vector<std::size_t> Order() const;
+
+    // threads 为 0 时 prepare 在 install 之前于本线程执行；
+    // 每个阶段的 install（含等待其 prepare）计入 profiler 的同名阶段；
+    // release 不为空时，每个数据在最后一个读取它的阶段 install 之后于本线程回调一次
+    void Run(uint32_t threads,
+             InstallProfiler& profiler,
+             const std::function<void(const std::string&)>& release = {});
+
+    // 把 [0, n) 分块执行 fn(begin, end)，调用线程也参与；Run() 之外或无工作线程时直接执行。
+    // 任一块抛出的异常在全部块结束后重新抛出
+    void ParallelFor(std::size_t n, const std::function<void(std::size_t, std::size_t)>& fn);
+
+  private:
+    class Pool;
+
+    std::vector<Stage> m_stages;
+    Pool* m_pool = nullptr;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_STAGE_GRAPH_H
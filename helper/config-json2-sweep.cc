@@ -0,0 +1,410 @@
+#include "config-json2-sweep.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Sweep");
+
+namespace
+{
+// 父进程允许使用的 CPU
+std::vector<int>
+AllowedCpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+        {
+            if (CPU_ISSET(c, &set))
+                cpus.push_back(c);
+        }
+    }
+    return cpus;
+}
+
+std::string
+DescribeStatus(int status)
+{
+    if (WIFEXITED(status))
+        return "exit code " + std::to_string(WEXITSTATUS(status));
+    if (WIFSIGNALED(status))
+        return std::string("signal ") + strsignal(WTERMSIG(status));
+    return "status " + std::to_string(status);
+}
+
+// 跳过 binary FlowMonitor 导出的文件头："CJ2FLOW1" | u32 列数 | 每列 { u8 类型, u8 名字长度, 名字 }
+void
+SkipBinaryHeader(std::istream& is, const std::string& path)
+{
+    char magic[8];
+    uint32_t columns = 0;
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, "CJ2FLOW1", 8) != 0 ||
+        !is.read(reinterpret_cast<char*>(&columns), sizeof(columns)))
+    {
+        throw std::runtime_error("Not a FlowMonitor binary export: " + path);
+    }
+    for (uint32_t i = 0; i < columns; ++i)
+    {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        is.read(reinterpret_cast<char*>(&type), 1);
+        is.read(reinterpret_cast<char*>(&length), 1);
+        is.ignore(length);
+    }
+    if (!is)
+        throw std::runtime_error("Truncated FlowMonitor binary header: " + path);
+}
+} // namespace
+
+SweepRunner::SweepRunner(ConfigJsonHelper& helper)
+    : m_helper(helper)
+{
+}
+
+void
+SweepRunner::Parse()
+{
+    const json& jSweep = m_helper.handleJson.at(JsonDomain::Config).at("sweep");
+
+    const json* common = jSweep.contains("patch") ? &jSweep.at("patch") : nullptr;
+    auto addRun = [&](RunSpec spec, const json* own) {
+        if (common)
+            spec.patches.push_back(common);
+        if (own)
+            spec.patches.push_back(own);
+        m_runs.push_back(std::move(spec));
+    };
+
+    if (jSweep.contains("runs"))
+    {
+        for (const auto& jRun : jSweep.at("runs"))
+        {
+            RunSpec spec;
+            if (jRun.contains("seed"))
+                spec.seed = jRun.at("seed").get<uint32_t>();
+            if (jRun.contains("run"))
+                spec.run = jRun.at("run").get<uint64_t>();
+            addRun(std::move(spec), jRun.contains("patch") ? &jRun.at("patch") : nullptr);
+        }
+    }
+    else
+    {
+        const uint64_t from = jSweep.at("runFrom").get<uint64_t>();
+        const uint64_t to = jSweep.at("runTo").get<uint64_t>();
+        if (to < from)
+            throw std::invalid_argument("sweep: runTo < runFrom");
+        for (uint64_t r = from; r <= to; ++r)
+        {
+            RunSpec spec;
+            if (jSweep.contains("seed"))
+                spec.seed = jSweep.at("seed").get<uint32_t>();
+            spec.run = r;
+            addRun(std::move(spec), nullptr);
+        }
+    }
+    if (m_runs.empty())
+        throw std::invalid_argument("sweep: no runs");
+
+    // patch 的键必须是 config.json 的子文件键
+    for (const auto& spec : m_runs)
+    {
+        for (const json* patch : spec.patches)
+        {
+            for (auto it = patch->begin(); it != patch->end(); ++it)
+            {
+                bool known = false;
+                for (const auto& [key, domain] : ConfigFileKeys())
+                    known = known || key == it.key();
+                if (!known)
+                    throw std::invalid_argument("sweep: unknown patch target '" + it.key() + "'");
+            }
+        }
+    }
+
+    const auto cpus = AllowedCpus();
+    m_jobs = jSweep.value("jobs", static_cast<uint32_t>(std::max<std::size_t>(cpus.size(), 1)));
+    m_jobs = std::max<uint32_t>(1, std::min<uint32_t>(m_jobs, m_runs.size()));
+    m_keepRunFiles = jSweep.value("keepRunFiles", false);
+}
+
+uint32_t
+SweepRunner::Run()
+{
+    try
+    {
+        Parse();
+    }
+    catch (const std::exception& e)
+    {
+        NS_FATAL_ERROR("ConfigJson sweep failed: " << e.what());
+    }
+
+    const auto cpus = AllowedCpus();
+    NS_LOG_INFO("sweep: " << m_runs.size() << " runs, " << m_jobs << " jobs");
+
+    struct Child
+    {
+        uint32_t index;
+        uint32_t slot;
+        int fd;
+    };
+
+    std::map<pid_t, Child> children;
+    std::vector<bool> slotBusy(m_jobs, false);
+    std::vector<std::vector<RunOutput>> outputs(m_runs.size());
+    uint32_t next = 0;
+    uint32_t failed = 0;
+
+    while (next < m_runs.size() || !children.empty())
+    {
+        /* ---------- Launch ---------- */
+        while (next < m_runs.size() && children.size() < m_jobs)
+        {
+            uint32_t slot = 0;
+            while (slotBusy[slot])
+                ++slot;
+
+            int fds[2];
+            if (pipe(fds) != 0)
+                NS_FATAL_ERROR("sweep: pipe failed: " << std::strerror(errno));
+
+            // 子进程会继承未刷出的 stdio 缓冲
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+
+            pid_t pid = fork();
+            if (pid < 0)
+                NS_FATAL_ERROR("sweep: fork failed: " << std::strerror(errno));
+            if (pid == 0)
+            {
+                close(fds[0]);
+                for (const auto& [otherPid, other] : children)
+                    close(other.fd);
+                Worker(next, cpus.empty() ? -1 : cpus[slot % cpus.size()], fds[1]);
+            }
+
+            close(fds[1]);
+            slotBusy[slot] = true;
+            children[pid] = Child{next, slot, fds[0]};
+            NS_LOG_INFO("sweep: run " << next << " started (pid " << pid << ")");
+            ++next;
+        }
+
+        /* ---------- Reap ---------- */
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            NS_FATAL_ERROR("sweep: waitpid failed: " << std::strerror(errno));
+        }
+        auto it = children.find(pid);
+        if (it == children.end())
+            continue;
+        const Child child = it->second;
+        children.erase(it);
+        slotBusy[child.slot] = false;
+
+        // 子进程只在结束前写入几行输出登记，不会填满管道
+        std::string data;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(child.fd, buf, sizeof(buf))) > 0 || (n < 0 && errno == EINTR))
+        {
+            if (n > 0)
+                data.append(buf, n);
+        }
+        close(child.fd);
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        {
+            std::size_t pos = 0;
+            while (pos < data.size())
+            {
+                std::size_t end = data.find('\n', pos);
+                const std::string line = data.substr(pos, end - pos);
+                pos = end == std::string::npos ? data.size() : end + 1;
+
+                std::size_t t1 = line.find('\t');
+                std::size_t t2 = line.find('\t', t1 + 1);
+                if (t1 == std::string::npos || t2 == std::string::npos)
+                    continue;
+                outputs[child.index].push_back(
+                    {line.substr(0, t1), line.substr(t1 + 1, t2 - t1 - 1), line.substr(t2 + 1)});
+            }
+            NS_LOG_INFO("sweep: run " << child.index << " finished");
+        }
+        else
+        {
+            ++failed;
+            NS_LOG_WARN("sweep: run " << child.index << " failed (" << DescribeStatus(status)
+                                      << ")");
+        }
+    }
+
+    try
+    {
+        Merge(outputs);
+    }
+    catch (const std::exception& e)
+    {
+        NS_FATAL_ERROR("ConfigJson sweep merge failed: " << e.what());
+    }
+    NS_LOG_INFO("sweep: " << (m_runs.size() - failed) << "/" << m_runs.size() << " runs succeeded");
+    return failed;
+}
+
+void
+SweepRunner::ApplyPatch(const json& patch)
+{
+    for (auto it = patch.begin(); it != patch.end(); ++it)
+    {
+        JsonDomain domain = JsonDomain::Config;
+        for (const auto& [key, d] : ConfigFileKeys())
+        {
+            if (key == it.key())
+                domain = d;
+        }
+        json& target = m_helper.handleJson[domain];
+        if (it.value().is_array())
+            target = target.patch(it.value());
+        else
+            target.merge_patch(it.value());
+    }
+}
+
+void
+SweepRunner::Worker(uint32_t index, int cpu, int fd)
+{
+    int code = 0;
+    try
+    {
+        if (cpu >= 0)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+
+        /* ---------- Overlay ---------- */
+        const RunSpec& spec = m_runs[index];
+        for (const json* patch : spec.patches)
+            ApplyPatch(*patch);
+        if (!spec.patches.empty())
+            m_helper.Validate();
+
+        json& jSimulator = m_helper.handleJson[JsonDomain::Simulator];
+        if (spec.seed)
+            jSimulator["seed"] = *spec.seed;
+        if (spec.run)
+            jSimulator["run"] = *spec.run;
+        m_helper.outputTag = "-sweep" + std::to_string(index);
+
+        /* ---------- Install & Run ---------- */
+        m_helper.Install();
+        m_helper.WarmUpScheduler();
+        Simulator::Run();
+        Simulator::Destroy();
+
+        std::string data;
+        for (const auto& [base, format] : m_helper.mergeableOutputs)
+            data += base + '\t' + m_helper.OutputPath(base) + '\t' + format + '\n';
+        for (std::size_t off = 0; off < data.size();)
+        {
+            ssize_t n = write(fd, data.data() + off, data.size() - off);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                break;
+            off += n;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "sweep run " << index << ": " << e.what() << std::endl;
+        code = 1;
+    }
+
+    close(fd);
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    // 不执行父进程注册的析构和 atexit 回调
+    _exit(code);
+}
+
+void
+SweepRunner::Merge(const std::vector<std::vector<RunOutput>>& outputs) const
+{
+    // 基础路径 -> 各 run 的文件（按 run 顺序）
+    std::vector<std::string> bases;
+    std::map<std::string, std::pair<std::string, std::vector<std::string>>> parts;
+    for (const auto& runOutputs : outputs)
+    {
+        for (const auto& o : runOutputs)
+        {
+            auto& entry = parts[o.base];
+            if (entry.second.empty())
+            {
+                bases.push_back(o.base);
+                entry.first = o.format;
+            }
+            entry.second.push_back(o.path);
+        }
+    }
+
+    for (const auto& base : bases)
+    {
+        const auto& [format, files] = parts.at(base);
+        std::ofstream out(base, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Cannot open " + base);
+
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            std::ifstream in(files[i], std::ios::binary);
+            if (!in)
+                throw std::runtime_error("Cannot open " + files[i]);
+            if (i > 0 && format == "csv")
+                in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            else if (i > 0 && format == "binary")
+                SkipBinaryHeader(in, files[i]);
+            if (in.peek() != std::char_traits<char>::eof())
+                out << in.rdbuf();
+        }
+        out.close();
+        if (!out)
+            throw std::runtime_error("Write failed: " + base);
+
+        if (!m_keepRunFiles)
+        {
+            for (const auto& f : files)
+                std::remove(f.c_str());
+        }
+        NS_LOG_INFO("sweep: merged " << files.size() << " files into " << base);
+    }
+}
+} // namespace configjson2
+} // namespace ns3
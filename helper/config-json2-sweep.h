@@ -0,0 +1,83 @@
+/**
+ * @file config-json2-sweep.h
+ * @brief Parallel seed / parameter sweep with fork-after-parse.
+ */
+
+#ifndef CONFIG_JSON_SWEEP_H
+#define CONFIG_JSON_SWEEP_H
+
+#include "config-json2-helper.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * config.json 中的 "sweep" 块：
+ *
+ *   "sweep": {
+ *     "jobs": 8,                 // 同时运行的进程数，默认为可用 CPU 数
+ *     "runs": [                  // 每个元素一次仿真
+ *       {"seed": 1, "run": 1},
+ *       {"run": 2, "patch": {"simulator": {"stopTime": "20s"}}}
+ *     ],
+ *     "seed": 1, "runFrom": 1, "runTo": 16,   // 或简写：run 取 runFrom..runTo
+ *     "patch": {...},            // 所有 run 共用的覆盖项，先于各 run 自己的 patch 应用
+ *     "keepRunFiles": false      // 合并后保留各 run 的输出文件
+ *   }
+ *
+ * patch 以 config.json 的子文件键（nodes、links、simulator ...）索引：
+ * 值为对象时按 RFC 7396 merge patch 应用，为数组时按 RFC 6902 JSON Patch 应用。
+ *
+ * 父进程只解析并校验一次（ConfigJsonHelper::Load），之后为每个 run fork 一个子进程。
+ * 子进程以写时复制继承已解析的 handleJson，应用自己的 seed/run/patch 后执行
+ * Install() 和 Simulator::Run()；第 i 个并发槽位绑定到第 i 个可用 CPU。
+ * 各 run 的输出文件带 -sweep<i> 后缀，全部结束后 FlowMonitor 导出和采样文件
+ * 按 run 顺序合并到原路径（csv 去掉重复表头，binary 去掉重复文件头），
+ * 各行的 run 列即 RngRun，可据此区分。
+ *
+ * fork 要求父进程此时只有一个线程，因此必须在 Install() 之前调用，且不能与 MPI 同用。
+ */
+class SweepRunner
+{
+  public:
+    explicit SweepRunner(ConfigJsonHelper& helper);
+
+    // 执行全部 run，返回失败的 run 数
+    uint32_t Run();
+
+  private:
+    struct RunSpec
+    {
+        std::optional<uint32_t> seed;
+        std::optional<uint64_t> run;
+        std::vector<const json*> patches;
+    };
+
+    // 一个 run 登记的可合并输出：基础路径、实际路径、格式
+    struct RunOutput
+    {
+        std::string base;
+        std::string path;
+        std::string format;
+    };
+
+    void Parse();
+    [[noreturn]] void Worker(uint32_t index, int cpu, int fd);
+    void ApplyPatch(const json& patch);
+    void Merge(const std::vector<std::vector<RunOutput>>& outputs) const;
+
+    ConfigJsonHelper& m_helper;
+    std::vector<RunSpec> m_runs;
+    uint32_t m_jobs = 0;
+    bool m_keepRunFiles = false;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_SWEEP_H
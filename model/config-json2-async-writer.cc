@@ -0,0 +1,302 @@
+#include "config-json2-async-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <stdexcept>
+#include <thread>
+
+namespace ns3
+{
+namespace configjson2
+{
+struct AsyncIoSink
+{
+    std::FILE* fp = nullptr;
+    std::string path;
+    std::atomic<bool> failed{false};
+};
+
+namespace
+{
+struct AsyncIoJob
+{
+    enum class Op
+    {
+        Data,
+        Reopen,
+        Close
+    };
+
+    Op op = Op::Data;
+    std::shared_ptr<AsyncIoSink> sink;
+    std::vector<char> data;
+    std::string path;
+    std::promise<void>* done = nullptr;
+};
+
+/* ===============================
+ * Shared I/O thread
+ * =============================== */
+class AsyncIoWorker
+{
+  public:
+    static AsyncIoWorker& Get()
+    {
+        // fork 后子进程中没有 I/O 线程，互斥量状态也不可信：
+        // 丢弃（泄漏）继承来的实例，子进程首次使用时重建
+        static std::unique_ptr<AsyncIoWorker> worker = [] {
+            pthread_atfork(nullptr, nullptr, [] { (void)worker.release(); });
+            return std::unique_ptr<AsyncIoWorker>(new AsyncIoWorker());
+        }();
+        if (!worker)
+        {
+            worker.reset(new AsyncIoWorker());
+        }
+        return *worker;
+    }
+
+    ~AsyncIoWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cvWork.notify_one();
+        m_thread.join();
+    }
+
+    void Submit(AsyncIoJob&& job)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // 背压：待写数据过多时阻塞生产者，保证内存有上界
+        m_cvSpace.wait(lock, [this, &job] {
+            return m_pendingBytes == 0 || m_pendingBytes + job.data.size() <= kMaxPendingBytes;
+        });
+        m_pendingBytes += job.data.size();
+        m_queue.push_back(std::move(job));
+        m_cvWork.notify_one();
+    }
+
+    std::vector<char> AcquireBuffer(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty())
+        {
+            std::vector<char> buf = std::move(m_free.back());
+            m_free.pop_back();
+            return buf;
+        }
+        std::vector<char> buf;
+        buf.reserve(capacity);
+        return buf;
+    }
+
+  private:
+    static constexpr std::size_t kMaxPendingBytes = 256u << 20;
+    static constexpr std::size_t kMaxFreeBuffers = 16;
+
+    AsyncIoWorker()
+        : m_thread(&AsyncIoWorker::Run, this)
+    {
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_cvWork.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+            {
+                return; // m_stop 且已排空
+            }
+            AsyncIoJob job = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+
+            Process(job);
+
+            lock.lock();
+            m_pendingBytes -= job.data.size();
+            if (job.data.capacity() > 0 && m_free.size() < kMaxFreeBuffers)
+            {
+                job.data.clear();
+                m_free.push_back(std::move(job.data));
+            }
+            m_cvSpace.notify_all();
+            if (job.done)
+            {
+                job.done->set_value();
+            }
+        }
+    }
+
+    static void Process(AsyncIoJob& job)
+    {
+        AsyncIoSink& sink = *job.sink;
+        if (job.op == AsyncIoJob::Op::Data)
+        {
+            if (sink.fp && !job.data.empty() &&
+                std::fwrite(job.data.data(), 1, job.data.size(), sink.fp) != job.data.size())
+            {
+                sink.failed = true;
+            }
+        }
+        else if (job.op == AsyncIoJob::Op::Reopen)
+        {
+            if (sink.fp && std::fclose(sink.fp) != 0)
+            {
+                sink.failed = true;
+            }
+            sink.path = job.path;
+            sink.fp = std::fopen(job.path.c_str(), "wb");
+            if (!sink.fp)
+            {
+                sink.failed = true;
+                return;
+            }
+            std::setvbuf(sink.fp, nullptr, _IONBF, 0);
+        }
+        else if (job.op == AsyncIoJob::Op::Close)
+        {
+            if (sink.fp && std::fclose(sink.fp) != 0)
+            {
+                sink.failed = true;
+            }
+            sink.fp = nullptr;
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;
+    std::condition_variable m_cvSpace;
+    std::deque<AsyncIoJob> m_queue;
+    std::vector<std::vector<char>> m_free;
+    std::size_t m_pendingBytes = 0;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+} // namespace
+
+AsyncFileWriter::AsyncFileWriter(const std::string& path, std::size_t bufferSize)
+    : m_sink(std::make_shared<AsyncIoSink>()),
+      m_bufferSize(bufferSize),
+      m_path(path)
+{
+    m_sink->path = path;
+    m_sink->fp = std::fopen(path.c_str(), "wb");
+    if (!m_sink->fp)
+    {
+        throw std::runtime_error("AsyncFileWriter: cannot open output file: " + path);
+    }
+    // 数据已在本对象中成块缓冲，关闭 stdio 的二次缓冲
+    std::setvbuf(m_sink->fp, nullptr, _IONBF, 0);
+    m_buffer = AsyncIoWorker::Get().AcquireBuffer(m_bufferSize);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    Close();
+}
+
+void
+AsyncFileWriter::Write(const void* data, std::size_t size)
+{
+    NS_ASSERT_MSG(!m_closed, "AsyncFileWriter: write after close: " << m_path);
+    if (m_buffer.size() + size > m_bufferSize && !m_buffer.empty())
+    {
+        Flush();
+    }
+    const char* p = static_cast<const char*>(data);
+    m_buffer.insert(m_buffer.end(), p, p + size);
+    m_fileBytes += size;
+}
+
+void
+AsyncFileWriter::Write(const std::string& s)
+{
+    Write(s.data(), s.size());
+}
+
+void
+AsyncFileWriter::Flush()
+{
+    if (m_sink->failed)
+    {
+        NS_FATAL_ERROR("AsyncFileWriter: write failed: " << m_path);
+    }
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    AsyncIoJob job;
+    job.op = AsyncIoJob::Op::Data;
+    job.sink = m_sink;
+    job.data = std::move(m_buffer);
+    AsyncIoWorker::Get().Submit(std::move(job));
+    m_buffer = AsyncIoWorker::Get().AcquireBuffer(m_bufferSize);
+}
+
+void
+AsyncFileWriter::Reopen(const std::string& path)
+{
+    NS_ASSERT_MSG(!m_closed, "AsyncFileWriter: reopen after close: " << m_path);
+    Flush();
+
+    AsyncIoJob job;
+    job.op = AsyncIoJob::Op::Reopen;
+    job.sink = m_sink;
+    job.path = path;
+    AsyncIoWorker::Get().Submit(std::move(job));
+
+    m_path = path;
+    m_fileBytes = 0;
+}
+
+void
+AsyncFileWriter::Close()
+{
+    if (m_closed)
+    {
+        return;
+    }
+    Flush();
+    m_closed = true;
+
+    std::promise<void> done;
+    std::future<void> doneFuture = done.get_future();
+    AsyncIoJob job;
+    job.op = AsyncIoJob::Op::Close;
+    job.sink = m_sink;
+    job.done = &done;
+    AsyncIoWorker::Get().Submit(std::move(job));
+    doneFuture.wait();
+
+    if (m_sink->failed)
+    {
+        NS_FATAL_ERROR("AsyncFileWriter: write failed: " << m_path);
+    }
+}
+
+const std::string&
+AsyncFileWriter::GetPath() const
+{
+    return m_path;
+}
+
+uint64_t
+AsyncFileWriter::GetFileBytes() const
+{
+    return m_fileBytes;
+}
+} // namespace configjson2
+} // namespace ns3
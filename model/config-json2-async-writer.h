@@ -0,0 +1,60 @@
+/**
+ * @file config-json2-async-writer.h
+ * @brief Buffered file writer drained by a shared background I/O thread.
+ */
+
+#ifndef CONFIG_JSON_ASYNC_WRITER_H
+#define CONFIG_JSON_ASYNC_WRITER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+struct AsyncIoSink;
+
+/**
+ * 仿真线程只做内存拷贝，写盘交给后台 I/O 线程。
+ *
+ * Write() 追加到本对象的缓冲区，缓冲区满后整块移交给 I/O 线程；
+ * 所有 writer 共用一个 I/O 线程，待写数据总量有上限，超过时 Write() 阻塞。
+ * 同一个 writer 的数据按提交顺序落盘。
+ */
+class AsyncFileWriter
+{
+  public:
+    explicit AsyncFileWriter(const std::string& path, std::size_t bufferSize = 4u << 20);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    void Write(const void* data, std::size_t size);
+    void Write(const std::string& s);
+    // 把当前缓冲区移交给 I/O 线程，不等待落盘
+    void Flush();
+    // 切换到新文件：之前写入的数据仍落到旧文件，打开新文件由 I/O 线程完成
+    void Reopen(const std::string& path);
+    // 落盘并关闭文件，阻塞到 I/O 线程处理完本 writer 的数据
+    void Close();
+
+    const std::string& GetPath() const;
+    // 已写入当前文件的字节数（含仍在缓冲区中的数据）
+    uint64_t GetFileBytes() const;
+
+  private:
+    std::shared_ptr<AsyncIoSink> m_sink;
+    std::vector<char> m_buffer;
+    std::size_t m_bufferSize;
+    std::string m_path;
+    uint64_t m_fileBytes = 0;
+    bool m_closed = false;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_ASYNC_WRITER_H
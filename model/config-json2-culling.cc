@@ -0,0 +1,168 @@
+#include "config-json2-culling.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Culling");
+
+NS_OBJECT_ENSURE_REGISTERED(GridTransmitFilter);
+
+TypeId
+GridTransmitFilter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::configjson2::GridTransmitFilter")
+            .SetParent<SpectrumTransmitFilter>()
+            .SetGroupName("ConfigJson2")
+            .AddConstructor<GridTransmitFilter>()
+            .AddAttribute("MaxRange",
+                          "Receivers farther than this (m) are skipped.",
+                          DoubleValue(std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&GridTransmitFilter::m_maxRange),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("MinRxPower",
+                          "Receivers whose estimated RX power (dBm) is below this are skipped.",
+                          DoubleValue(-std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&GridTransmitFilter::m_minRxPowerDbm),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("RefreshInterval",
+                          "Maximum age of the spatial index before it is rebuilt.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&GridTransmitFilter::m_refresh),
+                          MakeTimeChecker())
+            .AddAttribute("Margin",
+                          "Extra cell size (m) covering movement between index rebuilds.",
+                          DoubleValue(0),
+                          MakeDoubleAccessor(&GridTransmitFilter::m_margin),
+                          MakeDoubleChecker<double>(0));
+    return tid;
+}
+
+GridTransmitFilter::GridTransmitFilter()
+{
+}
+
+GridTransmitFilter::~GridTransmitFilter()
+{
+}
+
+void
+GridTransmitFilter::SetChannel(SpectrumChannel* channel)
+{
+    m_channel = channel;
+    m_built = false;
+}
+
+void
+GridTransmitFilter::SetPropagationLoss(Ptr<PropagationLossModel> loss)
+{
+    m_loss = loss;
+}
+
+void
+GridTransmitFilter::DoDispose()
+{
+    m_channel = nullptr;
+    m_loss = nullptr;
+    m_grid.clear();
+    m_candidates.clear();
+    SpectrumTransmitFilter::DoDispose();
+}
+
+int64_t
+GridTransmitFilter::DoAssignStreams(int64_t stream)
+{
+    return 0;
+}
+
+uint64_t
+GridTransmitFilter::CellOf(const Vector& position) const
+{
+    const double size = m_maxRange + m_margin;
+    const auto cx = static_cast<int32_t>(std::floor(position.x / size));
+    const auto cy = static_cast<int32_t>(std::floor(position.y / size));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+void
+GridTransmitFilter::Rebuild()
+{
+    m_grid.clear();
+    m_indexed = m_channel->GetNDevices();
+    for (std::size_t i = 0; i < m_indexed; ++i)
+    {
+        Ptr<NetDevice> dev = m_channel->GetDevice(i);
+        Ptr<MobilityModel> mobility = dev->GetNode()->GetObject<MobilityModel>();
+        if (mobility)
+            m_grid[CellOf(mobility->GetPosition())].push_back(PeekPointer(mobility));
+    }
+    m_builtAt = Simulator::Now();
+    m_built = true;
+    NS_LOG_DEBUG("grid rebuilt: " << m_indexed << " devices in " << m_grid.size() << " cells");
+}
+
+void
+GridTransmitFilter::Collect(Ptr<const MobilityModel> txMobility)
+{
+    if (!m_built || Simulator::Now() - m_builtAt >= m_refresh ||
+        m_channel->GetNDevices() != m_indexed)
+        Rebuild();
+
+    m_txMobility = PeekPointer(txMobility);
+    m_txTime = Simulator::Now();
+    m_candidates.clear();
+
+    const uint64_t center = CellOf(txMobility->GetPosition());
+    const auto cx = static_cast<int32_t>(center >> 32);
+    const auto cy = static_cast<int32_t>(center & 0xffffffff);
+    for (int32_t dx = -1; dx <= 1; ++dx)
+    {
+        for (int32_t dy = -1; dy <= 1; ++dy)
+        {
+            const uint64_t cell = (static_cast<uint64_t>(static_cast<uint32_t>(cx + dx)) << 32) |
+                                  static_cast<uint32_t>(cy + dy);
+            auto it = m_grid.find(cell);
+            if (it != m_grid.end())
+                m_candidates.insert(it->second.begin(), it->second.end());
+        }
+    }
+}
+
+bool
+GridTransmitFilter::DoFilter(Ptr<const SpectrumSignalParameters> params,
+                             Ptr<const SpectrumPhy> receiverPhy)
+{
+    // 没有位置信息时无法判断，不剔除
+    Ptr<const MobilityModel> txMobility;
+    if (params->txPhy)
+        txMobility = params->txPhy->GetMobility();
+    Ptr<const MobilityModel> rxMobility = receiverPhy->GetMobility();
+    if (!m_channel || !txMobility || !rxMobility)
+        return false;
+
+    // 同一发送者同一时刻的候选集合相同，每次发送只收集一次
+    if (PeekPointer(txMobility) != m_txMobility || Simulator::Now() != m_txTime)
+        Collect(txMobility);
+
+    if (!m_candidates.count(PeekPointer(rxMobility)))
+        return true;
+    if (txMobility->GetDistanceFrom(rxMobility) > m_maxRange)
+        return true;
+
+    if (m_loss && params->psd && std::isfinite(m_minRxPowerDbm))
+    {
+        const double txPowerDbm = 10 * std::log10(Integral(*params->psd)) + 30;
+        const double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm,
+                                                      ConstCast<MobilityModel>(txMobility),
+                                                      ConstCast<MobilityModel>(rxMobility));
+        if (rxPowerDbm < m_minRxPowerDbm)
+            return true;
+    }
+    return false;
+}
+} // namespace configjson2
+} // namespace ns3
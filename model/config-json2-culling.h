@@ -0,0 +1,79 @@
+/**
+ * @file config-json2-culling.h
+ * @brief Spectrum transmit filter that skips receivers out of range, using a spatial grid.
+ */
+
+#ifndef CONFIG_JSON_CULLING_H
+#define CONFIG_JSON_CULLING_H
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/spectrum-module.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * 按距离 / 接收功率剔除接收者的 SpectrumTransmitFilter。
+ *
+ * 信道中各接收者的位置按 MaxRange + Margin 大小的格子建索引，索引超过 RefreshInterval
+ * 后在下一次发送时重建。一次发送第一次调用 DoFilter 时查出发送者所在格子及其周围 8 格的接收者，
+ * 之后每个接收者只查一次哈希表：格子外的接收者不再计算传播损耗、复制信号参数和调度接收事件，
+ * 每帧的开销随邻居数而不是信道上的站点数增长。
+ *
+ * 格子内的候选再按当前位置精确判断距离；设置 MinRxPower 时还按传播损耗模型估算接收功率。
+ * 节点在两次重建之间移动的距离应小于 Margin，否则可能漏掉刚进入范围的接收者。
+ */
+class GridTransmitFilter : public SpectrumTransmitFilter
+{
+  public:
+    static TypeId GetTypeId();
+
+    GridTransmitFilter();
+    ~GridTransmitFilter() override;
+
+    // 索引来源；不持有引用，信道持有本过滤器
+    void SetChannel(SpectrumChannel* channel);
+    // MinRxPower 使用的损耗模型，一般为信道的损耗链表头
+    void SetPropagationLoss(Ptr<PropagationLossModel> loss);
+
+  protected:
+    void DoDispose() override;
+    bool DoFilter(Ptr<const SpectrumSignalParameters> params,
+                  Ptr<const SpectrumPhy> receiverPhy) override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+  private:
+    uint64_t CellOf(const Vector& position) const;
+    void Rebuild();
+    // 发送者或时刻变化时重新收集候选接收者
+    void Collect(Ptr<const MobilityModel> txMobility);
+
+    double m_maxRange;
+    double m_minRxPowerDbm;
+    Time m_refresh;
+    double m_margin;
+
+    SpectrumChannel* m_channel = nullptr;
+    Ptr<PropagationLossModel> m_loss;
+
+    std::unordered_map<uint64_t, std::vector<const MobilityModel*>> m_grid;
+    std::size_t m_indexed = 0; // 建索引时的设备数，信道增加设备后重建
+    Time m_builtAt;
+    bool m_built = false;
+
+    const MobilityModel* m_txMobility = nullptr;
+    Time m_txTime;
+    std::unordered_set<const MobilityModel*> m_candidates;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_CULLING_H
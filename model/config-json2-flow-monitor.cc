@@ -0,0 +1,612 @@
+#include "config-json2-flow-monitor.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace ns3
+{
+namespace configjson2
+{
+namespace
+{
+void
+AppendUint(std::string& out, uint64_t v)
+{
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+void
+AppendInt(std::string& out, int64_t v)
+{
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+void
+AppendDouble(std::string& out, double v)
+{
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.3f", v);
+    out.append(buf, n);
+}
+
+template <typename T>
+void
+AppendRaw(std::string& out, const T& v)
+{
+    out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+bool
+XmlAttribute(const std::string& line, const std::string& key, std::string& value)
+{
+    const std::string pattern = " " + key + "=\"";
+    auto pos = line.find(pattern);
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    pos += pattern.size();
+    auto end = line.find('"', pos);
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    value = line.substr(pos, end - pos);
+    return true;
+}
+
+// 列定义与 CSV 表头、binary 列表保持同一顺序（run/time 在 binary 中属于块头）
+struct ColumnDef
+{
+    const char* name;
+    uint8_t type;
+};
+
+const ColumnDef kColumns[] = {
+    {"flowId", 0},         {"protocol", 0},     {"srcAddr", 3},       {"srcPort", 0},
+    {"dstAddr", 3},        {"dstPort", 0},      {"txBytes", 0},       {"rxBytes", 0},
+    {"txPackets", 0},      {"rxPackets", 0},    {"lostPackets", 0},   {"timesForwarded", 0},
+    {"delaySumNs", 1},     {"jitterSumNs", 1},  {"lastDelayNs", 1},   {"timeFirstTxNs", 1},
+    {"timeFirstRxNs", 1},  {"timeLastTxNs", 1}, {"timeLastRxNs", 1},  {"throughputBps", 2},
+    {"packetsDropped", 0}, {"bytesDropped", 0},
+};
+} // namespace
+
+FlowExportFormat
+ParseFlowExportFormat(const std::string& s)
+{
+    if (s == "csv")
+        return FlowExportFormat::Csv;
+    if (s == "jsonl")
+        return FlowExportFormat::Jsonl;
+    if (s == "binary")
+        return FlowExportFormat::Binary;
+    throw std::invalid_argument("Unknown FlowMonitor output format: " + s);
+}
+
+FlowTupleCache::FlowTupleCache(FlowMonitorHelper* flowHelper)
+    : m_flowHelper(flowHelper)
+{
+    m_unknown.source = m_unknown.destination = "unknown";
+}
+
+void
+FlowTupleCache::Resolve(const FlowMonitor::FlowStatsContainer& stats)
+{
+    bool missing = false;
+    for (const auto& entry : stats)
+    {
+        if (m_tuples.find(entry.first) == m_tuples.end())
+        {
+            missing = true;
+            break;
+        }
+    }
+    if (!missing)
+        return;
+
+    // 出现新流：整体序列化一次分类器，O(流数) 建立 FlowId -> 五元组
+    ParseClassifierXml(m_flowHelper->GetClassifier(), false);
+    ParseClassifierXml(m_flowHelper->GetClassifier6(), true);
+}
+
+void
+FlowTupleCache::ParseClassifierXml(Ptr<FlowClassifier> classifier, bool ipv6)
+{
+    if (!classifier)
+        return;
+
+    std::ostringstream os;
+    classifier->SerializeToXmlStream(os, 0);
+    std::istringstream is(os.str());
+
+    std::string line;
+    std::string value;
+    while (std::getline(is, line))
+    {
+        if (line.find("<Flow ") == std::string::npos || !XmlAttribute(line, "flowId", value))
+            continue;
+
+        FlowId flowId = std::stoul(value);
+        if (m_tuples.find(flowId) != m_tuples.end())
+            continue;
+
+        FlowTuple t;
+        XmlAttribute(line, "sourceAddress", t.source);
+        XmlAttribute(line, "destinationAddress", t.destination);
+        if (XmlAttribute(line, "protocol", value))
+            t.protocol = std::stoul(value);
+        if (XmlAttribute(line, "sourcePort", value))
+            t.sourcePort = std::stoul(value);
+        if (XmlAttribute(line, "destinationPort", value))
+            t.destinationPort = std::stoul(value);
+
+        if (ipv6)
+        {
+            Ipv6Address(t.source.c_str()).Serialize(t.sourceRaw.data());
+            Ipv6Address(t.destination.c_str()).Serialize(t.destinationRaw.data());
+        }
+        else
+        {
+            t.sourceRaw[10] = t.sourceRaw[11] = 0xff;
+            t.destinationRaw[10] = t.destinationRaw[11] = 0xff;
+            Ipv4Address(t.source.c_str()).Serialize(t.sourceRaw.data() + 12);
+            Ipv4Address(t.destination.c_str()).Serialize(t.destinationRaw.data() + 12);
+        }
+        m_tuples.emplace(flowId, std::move(t));
+    }
+}
+
+const FlowTupleCache::FlowTuple&
+FlowTupleCache::Find(FlowId flowId) const
+{
+    auto it = m_tuples.find(flowId);
+    return it != m_tuples.end() ? it->second : m_unknown;
+}
+
+FlowMonitorExporter::FlowMonitorExporter(FlowMonitorHelper* flowHelper,
+                                         Ptr<FlowMonitor> monitor,
+                                         const std::string& path,
+                                         FlowExportFormat format)
+    : m_monitor(monitor),
+      m_format(format),
+      m_writer(path),
+      m_tuples(flowHelper)
+{
+    WriteHeader();
+}
+
+void
+FlowMonitorExporter::Snapshot()
+{
+    if (!m_monitor)
+        return;
+
+    m_monitor->CheckForLostPackets();
+    const auto& stats = m_monitor->GetFlowStats();
+    m_tuples.Resolve(stats);
+
+    m_rows.clear();
+    m_rows.reserve(stats.size());
+    for (const auto& [flowId, s] : stats)
+    {
+        FlowRow row{flowId, &m_tuples.Find(flowId), &s, 0, 0, 0.0};
+        for (uint32_t n : s.packetsDropped)
+            row.packetsDropped += n;
+        for (uint64_t n : s.bytesDropped)
+            row.bytesDropped += n;
+        double rxSpan = (s.timeLastRxPacket - s.timeFirstRxPacket).GetSeconds();
+        row.throughput = rxSpan > 0 ? s.rxBytes * 8.0 / rxSpan : 0.0;
+        m_rows.push_back(row);
+    }
+
+    const int64_t timeNs = Simulator::Now().GetNanoSeconds();
+    const uint64_t run = RngSeedManager::GetRun();
+    switch (m_format)
+    {
+    case FlowExportFormat::Csv:
+        WriteCsv(timeNs, run);
+        break;
+    case FlowExportFormat::Jsonl:
+        WriteJsonl(timeNs, run);
+        break;
+    case FlowExportFormat::Binary:
+        WriteBinary(timeNs, run);
+        break;
+    }
+}
+
+void
+FlowMonitorExporter::Close()
+{
+    m_writer.Close();
+}
+
+void
+FlowMonitorExporter::WriteHeader()
+{
+    m_line.clear();
+    if (m_format == FlowExportFormat::Csv)
+    {
+        m_line = "run,timeNs";
+        for (const auto& c : kColumns)
+        {
+            m_line += ',';
+            m_line += c.name;
+        }
+        m_line += '\n';
+    }
+    else if (m_format == FlowExportFormat::Binary)
+    {
+        m_line.append("CJ2FLOW1", 8);
+        AppendRaw(m_line, static_cast<uint32_t>(std::size(kColumns)));
+        for (const auto& c : kColumns)
+        {
+            AppendRaw(m_line, c.type);
+            AppendRaw(m_line, static_cast<uint8_t>(std::char_traits<char>::length(c.name)));
+            m_line += c.name;
+        }
+    }
+    m_writer.Write(m_line);
+}
+
+void
+FlowMonitorExporter::WriteCsv(int64_t timeNs, uint64_t run)
+{
+    for (const auto& r : m_rows)
+    {
+        const auto& s = *r.stats;
+        const auto& t = *r.tuple;
+        m_line.clear();
+        AppendUint(m_line, run);
+        m_line += ',';
+        AppendInt(m_line, timeNs);
+        m_line += ',';
+        AppendUint(m_line, r.flowId);
+        m_line += ',';
+        AppendUint(m_line, t.protocol);
+        m_line += ',';
+        m_line += t.source;
+        m_line += ',';
+        AppendUint(m_line, t.sourcePort);
+        m_line += ',';
+        m_line += t.destination;
+        m_line += ',';
+        AppendUint(m_line, t.destinationPort);
+        for (uint64_t v : {s.txBytes, s.rxBytes})
+        {
+            m_line += ',';
+            AppendUint(m_line, v);
+        }
+        for (uint64_t v : {s.txPackets, s.rxPackets, s.lostPackets, s.timesForwarded})
+        {
+            m_line += ',';
+            AppendUint(m_line, v);
+        }
+        for (const Time& v : {s.delaySum,
+                              s.jitterSum,
+                              s.lastDelay,
+                              s.timeFirstTxPacket,
+                              s.timeFirstRxPacket,
+                              s.timeLastTxPacket,
+                              s.timeLastRxPacket})
+        {
+            m_line += ',';
+            AppendInt(m_line, v.GetNanoSeconds());
+        }
+        m_line += ',';
+        AppendDouble(m_line, r.throughput);
+        m_line += ',';
+        AppendUint(m_line, r.packetsDropped);
+        m_line += ',';
+        AppendUint(m_line, r.bytesDropped);
+        m_line += '\n';
+        m_writer.Write(m_line);
+    }
+}
+
+void
+FlowMonitorExporter::WriteJsonl(int64_t timeNs, uint64_t run)
+{
+    for (const auto& r : m_rows)
+    {
+        const auto& s = *r.stats;
+        const auto& t = *r.tuple;
+        m_line.clear();
+        m_line += "{\"run\":";
+        AppendUint(m_line, run);
+        m_line += ",\"timeNs\":";
+        AppendInt(m_line, timeNs);
+        m_line += ",\"flowId\":";
+        AppendUint(m_line, r.flowId);
+        m_line += ",\"protocol\":";
+        AppendUint(m_line, t.protocol);
+        m_line += ",\"srcAddr\":\"";
+        m_line += t.source;
+        m_line += "\",\"srcPort\":";
+        AppendUint(m_line, t.sourcePort);
+        m_line += ",\"dstAddr\":\"";
+        m_line += t.destination;
+        m_line += "\",\"dstPort\":";
+        AppendUint(m_line, t.destinationPort);
+        m_line += ",\"txBytes\":";
+        AppendUint(m_line, s.txBytes);
+        m_line += ",\"rxBytes\":";
+        AppendUint(m_line, s.rxBytes);
+        m_line += ",\"txPackets\":";
+        AppendUint(m_line, s.txPackets);
+        m_line += ",\"rxPackets\":";
+        AppendUint(m_line, s.rxPackets);
+        m_line += ",\"lostPackets\":";
+        AppendUint(m_line, s.lostPackets);
+        m_line += ",\"timesForwarded\":";
+        AppendUint(m_line, s.timesForwarded);
+        m_line += ",\"delaySumNs\":";
+        AppendInt(m_line, s.delaySum.GetNanoSeconds());
+        m_line += ",\"jitterSumNs\":";
+        AppendInt(m_line, s.jitterSum.GetNanoSeconds());
+        m_line += ",\"lastDelayNs\":";
+        AppendInt(m_line, s.lastDelay.GetNanoSeconds());
+        m_line += ",\"timeFirstTxNs\":";
+        AppendInt(m_line, s.timeFirstTxPacket.GetNanoSeconds());
+        m_line += ",\"timeFirstRxNs\":";
+        AppendInt(m_line, s.timeFirstRxPacket.GetNanoSeconds());
+        m_line += ",\"timeLastTxNs\":";
+        AppendInt(m_line, s.timeLastTxPacket.GetNanoSeconds());
+        m_line += ",\"timeLastRxNs\":";
+        AppendInt(m_line, s.timeLastRxPacket.GetNanoSeconds());
+        m_line += ",\"throughputBps\":";
+        AppendDouble(m_line, r.throughput);
+        m_line += ",\"packetsDropped\":";
+        AppendUint(m_line, r.packetsDropped);
+        m_line += ",\"bytesDropped\":";
+        AppendUint(m_line, r.bytesDropped);
+        m_line += "}\n";
+        m_writer.Write(m_line);
+    }
+}
+
+void
+FlowMonitorExporter::WriteBinary(int64_t timeNs, uint64_t run)
+{
+    m_line.clear();
+    m_line.append("FBLK", 4);
+    AppendRaw(m_line, timeNs);
+    AppendRaw(m_line, run);
+    AppendRaw(m_line, static_cast<uint32_t>(m_rows.size()));
+    m_writer.Write(m_line);
+
+    // 按列写出：同一列的值连续存放，便于下游按列映射读取
+    auto column = [this](auto get) {
+        m_line.clear();
+        for (const auto& r : m_rows)
+            AppendRaw(m_line, get(r));
+        m_writer.Write(m_line);
+    };
+    auto address = [this](bool source) {
+        m_line.clear();
+        for (const auto& r : m_rows)
+        {
+            const auto& raw = source ? r.tuple->sourceRaw : r.tuple->destinationRaw;
+            m_line.append(reinterpret_cast<const char*>(raw.data()), raw.size());
+        }
+        m_writer.Write(m_line);
+    };
+
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.flowId); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.tuple->protocol); });
+    address(true);
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.tuple->sourcePort); });
+    address(false);
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.tuple->destinationPort); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->txBytes); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->rxBytes); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->txPackets); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->rxPackets); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->lostPackets); });
+    column([](const FlowRow& r) { return static_cast<uint64_t>(r.stats->timesForwarded); });
+    column([](const FlowRow& r) { return r.stats->delaySum.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->jitterSum.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->lastDelay.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->timeFirstTxPacket.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->timeFirstRxPacket.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->timeLastTxPacket.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.stats->timeLastRxPacket.GetNanoSeconds(); });
+    column([](const FlowRow& r) { return r.throughput; });
+    column([](const FlowRow& r) { return r.packetsDropped; });
+    column([](const FlowRow& r) { return r.bytesDropped; });
+}
+
+void
+FlowMonitorSampler::FlowSample::Merge(const FlowSample& next)
+{
+    timeNs = next.timeNs;
+    intervalNs += next.intervalNs;
+    txBytes += next.txBytes;
+    rxBytes += next.rxBytes;
+    txPackets += next.txPackets;
+    rxPackets += next.rxPackets;
+    lostPackets += next.lostPackets;
+    delaySumNs += next.delaySumNs;
+    jitterSumNs += next.jitterSumNs;
+}
+
+FlowMonitorSampler::FlowMonitorSampler(FlowMonitorHelper* flowHelper,
+                                       Ptr<FlowMonitor> monitor,
+                                       const std::string& path,
+                                       Time interval,
+                                       uint32_t capacity,
+                                       OnFull onFull)
+    : m_monitor(monitor),
+      m_interval(interval),
+      m_capacity(capacity),
+      m_onFull(onFull),
+      m_writer(path),
+      m_tuples(flowHelper)
+{
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "flowMonitorSampling: interval must be > 0");
+    NS_ASSERT_MSG(capacity >= 2, "flowMonitorSampling: capacity must be >= 2");
+    m_writer.Write(std::string("run,flowId,protocol,srcAddr,srcPort,dstAddr,dstPort,timeNs,"
+                               "intervalNs,txBytes,rxBytes,txPackets,rxPackets,lostPackets,"
+                               "delaySumNs,jitterSumNs,throughputBps\n"));
+}
+
+void
+FlowMonitorSampler::Start()
+{
+    Simulator::Schedule(m_interval, &FlowMonitorSampler::Sample, this);
+}
+
+void
+FlowMonitorSampler::Sample()
+{
+    m_monitor->CheckForLostPackets();
+    const auto& stats = m_monitor->GetFlowStats();
+    const int64_t nowNs = Simulator::Now().GetNanoSeconds();
+    if (m_onFull == OnFull::Spill)
+        m_tuples.Resolve(stats);
+
+    for (const auto& [flowId, s] : stats)
+    {
+        FlowSeries& series = m_series[flowId];
+        if (series.samples.capacity() == 0)
+            series.samples.reserve(m_capacity);
+
+        FlowSample d;
+        d.timeNs = nowNs;
+        d.intervalNs = m_interval.GetNanoSeconds();
+        d.txBytes = s.txBytes - series.last.txBytes;
+        d.rxBytes = s.rxBytes - series.last.rxBytes;
+        d.txPackets = s.txPackets - series.last.txPackets;
+        d.rxPackets = s.rxPackets - series.last.rxPackets;
+        d.lostPackets = s.lostPackets - series.last.lostPackets;
+        d.delaySumNs = s.delaySum.GetNanoSeconds() - series.last.delaySumNs;
+        d.jitterSumNs = s.jitterSum.GetNanoSeconds() - series.last.jitterSumNs;
+
+        series.last.txBytes = s.txBytes;
+        series.last.rxBytes = s.rxBytes;
+        series.last.txPackets = s.txPackets;
+        series.last.rxPackets = s.rxPackets;
+        series.last.lostPackets = s.lostPackets;
+        series.last.delaySumNs = s.delaySum.GetNanoSeconds();
+        series.last.jitterSumNs = s.jitterSum.GetNanoSeconds();
+
+        Push(flowId, series, d);
+    }
+
+    Simulator::Schedule(m_interval, &FlowMonitorSampler::Sample, this);
+}
+
+void
+FlowMonitorSampler::Push(FlowId flowId, FlowSeries& series, const FlowSample& sample)
+{
+    // 降采样后每个样本覆盖 stride 个原始区间，先在 pending 中累加
+    if (series.pendingCount == 0)
+        series.pending = sample;
+    else
+        series.pending.Merge(sample);
+    if (++series.pendingCount < series.stride)
+        return;
+
+    series.samples.push_back(series.pending);
+    series.pendingCount = 0;
+    if (series.samples.size() < m_capacity)
+        return;
+
+    if (m_onFull == OnFull::Spill)
+    {
+        WriteSamples(flowId, series.samples);
+        series.samples.clear();
+        return;
+    }
+
+    /* ---------- Downsample: 两两合并，粒度加倍 ---------- */
+    std::size_t n = series.samples.size();
+    std::size_t out = 0;
+    for (std::size_t i = 0; i + 1 < n; i += 2)
+    {
+        FlowSample merged = series.samples[i];
+        merged.Merge(series.samples[i + 1]);
+        series.samples[out++] = merged;
+    }
+    if (n % 2 == 1)
+    {
+        // 奇数个时最后一个样本转入 pending，继续累加到新粒度
+        series.pending = series.samples[n - 1];
+        series.pendingCount = series.stride;
+    }
+    series.samples.resize(out);
+    series.stride *= 2;
+}
+
+void
+FlowMonitorSampler::WriteSamples(FlowId flowId, const std::vector<FlowSample>& samples)
+{
+    const auto& t = m_tuples.Find(flowId);
+    const uint64_t run = RngSeedManager::GetRun();
+    for (const auto& d : samples)
+    {
+        m_line.clear();
+        AppendUint(m_line, run);
+        m_line += ',';
+        AppendUint(m_line, flowId);
+        m_line += ',';
+        AppendUint(m_line, t.protocol);
+        m_line += ',';
+        m_line += t.source;
+        m_line += ',';
+        AppendUint(m_line, t.sourcePort);
+        m_line += ',';
+        m_line += t.destination;
+        m_line += ',';
+        AppendUint(m_line, t.destinationPort);
+        for (int64_t v : {d.timeNs, d.intervalNs})
+        {
+            m_line += ',';
+            AppendInt(m_line, v);
+        }
+        for (uint64_t v : {d.txBytes, d.rxBytes, d.txPackets, d.rxPackets, d.lostPackets})
+        {
+            m_line += ',';
+            AppendUint(m_line, v);
+        }
+        for (int64_t v : {d.delaySumNs, d.jitterSumNs})
+        {
+            m_line += ',';
+            AppendInt(m_line, v);
+        }
+        m_line += ',';
+        AppendDouble(m_line, d.intervalNs > 0 ? d.rxBytes * 8e9 / d.intervalNs : 0.0);
+        m_line += '\n';
+        m_writer.Write(m_line);
+    }
+}
+
+void
+FlowMonitorSampler::Close()
+{
+    m_tuples.Resolve(m_monitor->GetFlowStats());
+    for (auto& [flowId, series] : m_series)
+    {
+        if (series.pendingCount > 0)
+        {
+            series.samples.push_back(series.pending);
+            series.pendingCount = 0;
+        }
+        WriteSamples(flowId, series.samples);
+        series.samples.clear();
+    }
+    m_writer.Close();
+}
+} // namespace configjson2
+} // namespace ns3
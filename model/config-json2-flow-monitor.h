@@ -0,0 +1,179 @@
+/**
+ * @file config-json2-flow-monitor.h
+ * @brief Structured FlowMonitor exporter (CSV / JSONL / binary columnar).
+ */
+
+#ifndef CONFIG_JSON_FLOW_MONITOR_H
+#define CONFIG_JSON_FLOW_MONITOR_H
+
+#include "config-json2-async-writer.h"
+
+#include "ns3/flow-monitor-module.h"
+
+#include <array>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+enum class FlowExportFormat
+{
+    Csv,
+    Jsonl,
+    Binary
+};
+
+FlowExportFormat ParseFlowExportFormat(const std::string& s);
+
+/**
+ * FlowId -> 五元组缓存。
+ *
+ * 只在出现新流时整体序列化一次分类器，O(流数) 建表，
+ * 避免 Ipv4FlowClassifier::FindFlow 的逐流线性查找。
+ */
+class FlowTupleCache
+{
+  public:
+    struct FlowTuple
+    {
+        std::string source;
+        std::string destination;
+        std::array<uint8_t, 16> sourceRaw{};
+        std::array<uint8_t, 16> destinationRaw{};
+        uint32_t protocol = 0;
+        uint32_t sourcePort = 0;
+        uint32_t destinationPort = 0;
+    };
+
+    explicit FlowTupleCache(FlowMonitorHelper* flowHelper);
+
+    void Resolve(const FlowMonitor::FlowStatsContainer& stats);
+    const FlowTuple& Find(FlowId flowId) const;
+
+  private:
+    void ParseClassifierXml(Ptr<FlowClassifier> classifier, bool ipv6);
+
+    FlowMonitorHelper* m_flowHelper;
+    std::unordered_map<FlowId, FlowTuple> m_tuples;
+    FlowTuple m_unknown;
+};
+
+/**
+ * 每次 Snapshot() 导出所有流的完整 FlowStats，
+ * 输出经 AsyncFileWriter 由后台线程写盘。
+ *
+ * binary 格式（主机字节序）：
+ *   文件头  "CJ2FLOW1" | u32 列数 | 每列 { u8 类型, u8 名字长度, 名字 }
+ *   数据块  "FBLK" | i64 时间(ns) | u64 run | u32 行数 | 按列连续存放的值
+ *   类型    0=u64  1=i64  2=f64  3=16 字节地址（IPv4 以 ::ffff:a.b.c.d 存放）
+ */
+class FlowMonitorExporter
+{
+  public:
+    FlowMonitorExporter(FlowMonitorHelper* flowHelper,
+                        Ptr<FlowMonitor> monitor,
+                        const std::string& path,
+                        FlowExportFormat format);
+
+    void Snapshot();
+    void Close();
+
+  private:
+    using FlowTuple = FlowTupleCache::FlowTuple;
+
+    struct FlowRow
+    {
+        FlowId flowId;
+        const FlowTuple* tuple;
+        const FlowMonitor::FlowStats* stats;
+        uint64_t packetsDropped;
+        uint64_t bytesDropped;
+        double throughput;
+    };
+
+    void WriteHeader();
+    void WriteCsv(int64_t timeNs, uint64_t run);
+    void WriteJsonl(int64_t timeNs, uint64_t run);
+    void WriteBinary(int64_t timeNs, uint64_t run);
+
+    Ptr<FlowMonitor> m_monitor;
+    FlowExportFormat m_format;
+    AsyncFileWriter m_writer;
+    FlowTupleCache m_tuples;
+    std::vector<FlowRow> m_rows;
+    std::string m_line;
+};
+
+/**
+ * 固定间隔采样每条流的增量（字节、包数、丢包、时延和、抖动和）。
+ *
+ * 每条流一个容量固定的缓冲区，内存上界为 流数 x capacity 个样本。缓冲区满时：
+ *   downsample  相邻样本两两合并，采样粒度加倍，历史保留到仿真结束；
+ *   spill       当前缓冲区整体写盘后清空，保留全精度。
+ * 仿真结束（Simulator::Destroy）时写出剩余样本，CSV 一行一个样本。
+ */
+class FlowMonitorSampler
+{
+  public:
+    enum class OnFull
+    {
+        Downsample,
+        Spill
+    };
+
+    FlowMonitorSampler(FlowMonitorHelper* flowHelper,
+                       Ptr<FlowMonitor> monitor,
+                       const std::string& path,
+                       Time interval,
+                       uint32_t capacity,
+                       OnFull onFull);
+
+    void Start();
+    void Close();
+
+  private:
+    struct FlowSample
+    {
+        int64_t timeNs = 0;     // 区间结束时刻
+        int64_t intervalNs = 0; // 区间长度
+        uint64_t txBytes = 0;
+        uint64_t rxBytes = 0;
+        uint64_t txPackets = 0;
+        uint64_t rxPackets = 0;
+        uint64_t lostPackets = 0;
+        int64_t delaySumNs = 0;
+        int64_t jitterSumNs = 0;
+
+        void Merge(const FlowSample& next);
+    };
+
+    struct FlowSeries
+    {
+        std::vector<FlowSample> samples; // 容量固定为 capacity
+        FlowSample pending;              // 降采样后尚未凑满 stride 的累加值
+        uint32_t pendingCount = 0;
+        uint32_t stride = 1;
+        FlowSample last;                 // 上次采样时的累计值
+    };
+
+    void Sample();
+    void Push(FlowId flowId, FlowSeries& series, const FlowSample& sample);
+    void WriteSamples(FlowId flowId, const std::vector<FlowSample>& samples);
+
+    Ptr<FlowMonitor> m_monitor;
+    Time m_interval;
+    uint32_t m_capacity;
+    OnFull m_onFull;
+    AsyncFileWriter m_writer;
+    FlowTupleCache m_tuples;
+    std::map<FlowId, FlowSeries> m_series;
+    std::string m_line;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_FLOW_MONITOR_H
@@ -3,28 +3,8 @@
 namespace ns3
 {
 namespace configjson2 {
-using json = nlohmann::json;
 
-WifiStandard
-ParseWifiStandard(const std::string& s)
-{
-    static const std::unordered_map<std::string, WifiStandard> table = {
-        {"WIFI_STANDARD_80211a", WIFI_STANDARD_80211a},
-        {"WIFI_STANDARD_80211b", WIFI_STANDARD_80211b},
-        {"WIFI_STANDARD_80211g", WIFI_STANDARD_80211g},
-        {"WIFI_STANDARD_80211n", WIFI_STANDARD_80211n},
-        {"WIFI_STANDARD_80211ac", WIFI_STANDARD_80211ac},
-        {"WIFI_STANDARD_80211ax", WIFI_STANDARD_80211ax},
-        {"WIFI_STANDARD_80211be", WIFI_STANDARD_80211be},
-    };
-
-    auto it = table.find(s);
-    if (it == table.end())
-    {
-        throw std::invalid_argument("Unknown WifiStandard: " + s);
-    }
-    return it->second;
-}
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Handler");
 
 void
 ConfigHandler(const json& jConfig, ConfigJsonHelper& helper)
@@ -32,44 +12,65 @@ ConfigHandler(const json& jConfig, ConfigJsonHelper& helper)
     auto baseDir = helper.configPath.parent_path();
 
     /* ===============================
-     * Load sub JSON files
+     * Profiler (optional)
      * =============================== */
-    helper.handleJson[JsonDomain::Node] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("nodes").get<std::string>());
-
-    helper.handleJson[JsonDomain::Link] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("links").get<std::string>());
-
-    helper.handleJson[JsonDomain::Internet] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("internet").get<std::string>());
-
-    helper.handleJson[JsonDomain::Ipv4Network] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("ipv4Network").get<std::string>());
-
-    helper.handleJson[JsonDomain::Ipv6Network] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("ipv6Network").get<std::string>());
-
-    helper.handleJson[JsonDomain::Ipv4RoutingProtocol] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("ipv4RoutingProtocol").get<std::string>());
+    if (jConfig.contains("profile"))
+    {
+        const auto& jProfile = jConfig.at("profile");
+        if (jProfile.is_string())
+            helper.profiler.Enable(jProfile.get<std::string>());
+        else
+        {
+            helper.profiler.Enable(jProfile.value("file", "install-profile.json"),
+                                   jProfile.value("format", ""));
+            if (jProfile.value("memory", false))
+                helper.profiler.EnableMemory();
+        }
+    }
 
-    helper.handleJson[JsonDomain::Ipv6RoutingProtocol] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("ipv6RoutingProtocol").get<std::string>());
+    // Install 各阶段 prepare 的工作线程数
+    if (jConfig.contains("installThreads"))
+        helper.installThreads = jConfig.at("installThreads").get<uint32_t>();
+    // 各 domain 的 json 在最后使用它的阶段之后释放；安装后仍要读 handleJson 时关闭
+    if (jConfig.contains("releaseJson"))
+        helper.releaseJson = jConfig.at("releaseJson").get<bool>();
 
-    helper.handleJson[JsonDomain::Mobility] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("mobility").get<std::string>());
+    // 链路 / 应用 profile，在这里解码一次，安装时按名字复用
+    if (jConfig.contains("profiles"))
+        helper.profiles = ProfileSet::Decode(jConfig.at("profiles"));
 
-    helper.handleJson[JsonDomain::Application] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("applications").get<std::string>());
+    /* ===============================
+     * Load sub JSON files
+     * =============================== */
+    static const std::string kLoad = "Load";
+    auto load = [&](JsonDomain domain, const std::string& key) {
+        // 值可以是文件、glob、序号区间或它们的数组，多个分片并行解析
+        const auto paths = ConfigJsonHelper::ExpandShards(baseDir, jConfig.at(key));
+        if (!helper.profiler.IsEnabled())
+        {
+            helper.LoadDomain(domain, paths);
+            return;
+        }
+        InstallProfiler::Scope scope(helper.profiler, kLoad, key);
+        helper.LoadDomain(domain, paths);
+    };
 
-    helper.handleJson[JsonDomain::Simulator] =
-        ConfigJsonHelper::LoadJson(baseDir / jConfig.at("simulator").get<std::string>());
+    for (const auto& [key, domain] : ConfigFileKeys())
+    {
+        // timeline 可选，其余子文件必须给出
+        if (domain == JsonDomain::Timeline && !jConfig.contains(key))
+            continue;
+        load(domain, key);
+    }
 }
 
 void
 NodeHandler(const json& jNode, ConfigJsonHelper& helper)
 {
-    Ptr<Node> node = CreateObject<Node>();
-    Names::Add("node" + std::to_string(jNode.at("nodeId").get<uint32_t>()), node);
+    uint32_t nodeId = jNode.at("nodeId").get<uint32_t>();
+    // 分布式时按划分结果指定 systemId，顺序安装时为 0
+    Ptr<Node> node = CreateObject<Node>(helper.GetSystemId(nodeId));
+    Names::Add("node" + std::to_string(nodeId), node);
 }
 
 void
@@ -126,162 +127,88 @@ SwitchHandler(const json& jNode, ConfigJsonHelper& helper)
 }
 
 void
-WifiLinkHandler(const json& jLink, ConfigJsonHelper&)
+WifiLinkHandler(const json& jLink, ConfigJsonHelper& helper)
 {
     uint32_t linkId = jLink.at("linkId").get<uint32_t>();
 
-    /* ---------- WifiHelper ---------- */
-    WifiHelper wifi;
-    wifi.SetStandard(ParseWifiStandard(jLink.at("wifiStandard").get<std::string>()));
-
-    const auto& wm = jLink.at("wifiManager");
-    wifi.SetRemoteStationManager(wm.at("type").get<std::string>(),
-                                 "DataMode",
-                                 StringValue(wm.at("dataMode").get<std::string>()),
-                                 "ControlMode",
-                                 StringValue(wm.at("controlMode").get<std::string>()));
-
-    /* ---------- Channel ---------- */
-    Ptr<Channel> channel;
-    const auto& jChannel = jLink.at("channel");
-    std::string channelType = jChannel.at("type").get<std::string>();
-
-    if (channelType == "ns3::YansWifiChannel")
-    {
-        YansWifiChannelHelper ch;
-        ch.SetPropagationDelay(jChannel.at("propagationDelay").get<std::string>());
-
-        Ptr<PropagationLossModel> first = nullptr;
-        Ptr<PropagationLossModel> prev = nullptr;
-
-        for (const auto& loss : jChannel.at("propagationLoss"))
-        {
-            std::string type = loss.at("type").get<std::string>();
-            Ptr<PropagationLossModel> cur;
-
-            if (type == "ns3::FriisPropagationLossModel")
-                cur = CreateObject<FriisPropagationLossModel>();
-            else if (type == "ns3::LogDistancePropagationLossModel")
-                cur = CreateObject<LogDistancePropagationLossModel>();
-            else if (type == "ns3::NakagamiPropagationLossModel")
-                cur = CreateObject<NakagamiPropagationLossModel>();
-            else
-                NS_FATAL_ERROR("Unsupported PropagationLossModel: " << type);
-
-            if (!first)
-                first = cur;
-            if (prev)
-                prev->SetNext(cur);
-            prev = cur;
-        }
-
-        channel = ch.Create();
-        DynamicCast<YansWifiChannel>(channel)->SetPropagationLossModel(first);
-    }
-    else if (channelType == "ns3::SingleModelSpectrumChannel" ||
-             channelType == "ns3::MultiModelSpectrumChannel")
-    {
-        SpectrumChannelHelper ch;
-        ch.SetChannel(channelType);
-        ch.SetPropagationDelay(jChannel.at("propagationDelay").get<std::string>());
-
-        for (const auto& loss : jChannel.at("propagationLoss"))
-        {
-            std::string type = loss.at("type").get<std::string>();
-            Ptr<PropagationLossModel> m;
-
-            if (type == "ns3::FriisPropagationLossModel")
-                m = CreateObject<FriisPropagationLossModel>();
-            else if (type == "ns3::LogDistancePropagationLossModel")
-                m = CreateObject<LogDistancePropagationLossModel>();
-            else
-                NS_FATAL_ERROR("Unsupported PropagationLossModel: " << type);
-
-            ch.AddPropagationLoss(m);
-        }
-
-        channel = ch.Create();
-    }
+    /* ---------- WifiHelper / Channel ---------- */
+    // 引用 profile 时直接使用已解码的设置，否则按本链路的块解码
+    std::optional<WifiProfile> own;
+    const WifiProfile* profile;
+    if (jLink.contains("profile"))
+        profile = &GetProfiles(helper).FindWifi(jLink.at("profile").get<std::string>());
     else
-    {
-        NS_FATAL_ERROR("Unsupported Wifi channel type: " << channelType);
-    }
+        profile = &own.emplace(DecodeWifiProfile(jLink));
+
+    Ptr<Channel> channel = CreateWifiChannel(*profile);
+    const bool yans = profile->channelType == "ns3::YansWifiChannel";
 
     Names::Add("link" + std::to_string(linkId) + "-channel", channel);
 
     /* ---------- NetDevices ---------- */
+    // wifiMac / wifiPhy 块相同的设备分为一组，每组只配置一次 helper、调用一次 Install；
+    // 组按首次出现的顺序安装，组内保持 netDevices 中的顺序
+    struct DeviceGroup
+    {
+        const json* jMac = nullptr;
+        const json* jPhy = nullptr;
+        NodeContainer nodes;
+        std::vector<uint32_t> nodeIds;
+    };
+    std::vector<DeviceGroup> groups;
+    std::map<std::pair<std::string, std::string>, std::size_t> groupIndex;
+
     for (const auto& jDev : jLink.at("netDevices"))
     {
         uint32_t nodeId = jDev.at("nodeId").get<uint32_t>();
         Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
 
+        const json* jMac = jDev.contains("wifiMac") ? &jDev.at("wifiMac") : nullptr;
+        const json* jPhy = jDev.contains("wifiPhy") ? &jDev.at("wifiPhy") : nullptr;
+        if (!jMac && !profile->hasMac)
+            throw std::invalid_argument("wifi link " + std::to_string(linkId) + ": node" +
+                                        std::to_string(nodeId) + " has no wifiMac");
+
+        auto key = std::make_pair(jMac ? jMac->dump() : std::string(),
+                                  jPhy ? jPhy->dump() : std::string());
+        auto [it, inserted] = groupIndex.emplace(std::move(key), groups.size());
+        if (inserted)
+            groups.push_back({jMac, jPhy, {}, {}});
+        DeviceGroup& group = groups[it->second];
+        group.nodes.Add(node);
+        group.nodeIds.push_back(nodeId);
+    }
+
+    for (const auto& group : groups)
+    {
         /* MAC */
-        WifiMacHelper mac;
-        const auto& jMac = jDev.at("wifiMac");
-        mac.SetType(jMac.at("type").get<std::string>(),
-                    "Ssid",
-                    SsidValue(Ssid(jMac.at("ssid").get<std::string>())));
+        WifiMacHelper mac = profile->mac;
+        if (group.jMac)
+            ConfigureWifiMac(mac, *group.jMac);
 
         /* PHY */
-        Ptr<NetDevice> dev;
-        const auto& jPhy = jDev.at("wifiPhy");
-
-        if (channelType == "ns3::YansWifiChannel")
+        NetDeviceContainer devices;
+        if (yans)
         {
-            YansWifiPhyHelper phy;
+            YansWifiPhyHelper phy = profile->yansPhy;
             phy.SetChannel(DynamicCast<YansWifiChannel>(channel));
-            phy.SetErrorRateModel(jLink.at("errorRateModel").get<std::string>());
-
-            for (auto it = jPhy.begin(); it != jPhy.end(); ++it)
-            {
-                const std::string& k = it.key();
-                const auto& v = it.value();
-                if (k == "type")
-                    continue;
-
-                if (k == "channelSettings")
-                    phy.Set("ChannelSettings", StringValue(v.get<std::string>()));
-                else if (k == "txPowerStart")
-                    phy.Set("TxPowerStart", DoubleValue(v.get<double>()));
-                else if (k == "txPowerEnd")
-                    phy.Set("TxPowerEnd", DoubleValue(v.get<double>()));
-                else if (k == "rxSensitivity")
-                    phy.Set("RxSensitivity", DoubleValue(v.get<double>()));
-                else if (k == "ccaEdThreshold")
-                    phy.Set("CcaEdThreshold", DoubleValue(v.get<double>()));
-            }
-
-            dev = wifi.Install(phy, mac, node).Get(0);
+            if (group.jPhy)
+                ConfigureWifiPhy(phy, *group.jPhy);
+            devices = profile->wifi.Install(phy, mac, group.nodes);
         }
         else
         {
-            SpectrumWifiPhyHelper phy;
+            SpectrumWifiPhyHelper phy = profile->spectrumPhy;
             phy.SetChannel(DynamicCast<SpectrumChannel>(channel));
-            phy.SetErrorRateModel(jLink.at("errorRateModel").get<std::string>());
-
-            for (auto it = jPhy.begin(); it != jPhy.end(); ++it)
-            {
-                const std::string& k = it.key();
-                const auto& v = it.value();
-                if (k == "type")
-                    continue;
-
-                if (k == "channelSettings")
-                    phy.Set("ChannelSettings", StringValue(v.get<std::string>()));
-                else if (k == "txPowerStart")
-                    phy.Set("TxPowerStart", DoubleValue(v.get<double>()));
-                else if (k == "txPowerEnd")
-                    phy.Set("TxPowerEnd", DoubleValue(v.get<double>()));
-                else if (k == "rxSensitivity")
-                    phy.Set("RxSensitivity", DoubleValue(v.get<double>()));
-                else if (k == "ccaEdThreshold")
-                    phy.Set("CcaEdThreshold", DoubleValue(v.get<double>()));
-            }
-
-            dev = wifi.Install(phy, mac, node).Get(0);
+            if (group.jPhy)
+                ConfigureWifiPhy(phy, *group.jPhy);
+            devices = profile->wifi.Install(phy, mac, group.nodes);
         }
 
-        Names::Add("node" + std::to_string(nodeId) + "-link" + std::to_string(linkId), dev);
+        for (uint32_t i = 0; i < devices.GetN(); ++i)
+            Names::Add("node" + std::to_string(group.nodeIds[i]) + "-link" +
+                           std::to_string(linkId),
+                       devices.Get(i));
     }
 }
 
@@ -290,71 +217,11 @@ P2pLinkHandler(const json& jLink, ConfigJsonHelper& helper)
 {
     // 必需字段
     uint32_t linkId = jLink.at("linkId").get<uint32_t>();
+    // profile 的设置在前，本链路的 queue / channel / device 块覆盖其中的属性
     PointToPointHelper p2p;
-
-    /* ===============================
-     * Queue (optional)
-     * =============================== */
-    if (jLink.contains("queue"))
-    {
-        const auto& jQueue = jLink.at("queue");
-        for (auto it = jQueue.begin(); it != jQueue.end(); ++it)
-        {
-            const std::string& key = it.key();
-            const auto& val = it.value();
-
-            if (key == "type")
-            {
-                p2p.SetQueue(val.get<std::string>());
-            }
-        }
-    }
-
-    /* ===============================
-     * Channel attributes (optional)
-     * =============================== */
-    if (jLink.contains("channel"))
-    {
-        const auto& jChannel = jLink.at("channel");
-        for (auto it = jChannel.begin(); it != jChannel.end(); ++it)
-        {
-            const std::string& key = it.key();
-            const auto& val = it.value();
-
-            if (key == "type")
-                continue;
-
-            if (key == "delay")
-            {
-                p2p.SetChannelAttribute("Delay", TimeValue(Time(val.get<std::string>())));
-            }
-        }
-    }
-
-    /* ===============================
-     * Device attributes (optional)
-     * =============================== */
-    if (jLink.contains("device"))
-    {
-        const auto& jDevice = jLink.at("device");
-        for (auto it = jDevice.begin(); it != jDevice.end(); ++it)
-        {
-            const std::string& key = it.key();
-            const auto& val = it.value();
-
-            if (key == "type")
-                continue;
-
-            if (key == "dataRate")
-            {
-                p2p.SetDeviceAttribute("DataRate", DataRateValue(DataRate(val.get<std::string>())));
-            }
-            else if (key == "mtu")
-            {
-                p2p.SetDeviceAttribute("Mtu", UintegerValue(val.get<uint32_t>()));
-            }
-        }
-    }
+    if (jLink.contains("profile"))
+        p2p = GetProfiles(helper).FindP2p(jLink.at("profile").get<std::string>());
+    ConfigureP2p(p2p, jLink);
 
     /* ===============================
      * Nodes (required)
@@ -372,7 +239,7 @@ P2pLinkHandler(const json& jLink, ConfigJsonHelper& helper)
     NetDeviceContainer devices = p2p.Install(nodes);
 
     /* ===============================
-     * Name NetDevices
+     * Name NetDevices / Channel
      * =============================== */
     for (uint32_t i = 0; i < devices.GetN(); ++i)
     {
@@ -380,6 +247,7 @@ P2pLinkHandler(const json& jLink, ConfigJsonHelper& helper)
         std::string nodeName = Names::FindName(dev->GetNode());
         Names::Add(nodeName + "-link" + std::to_string(linkId), dev);
     }
+    Names::Add("link" + std::to_string(linkId) + "-channel", devices.Get(0)->GetChannel());
 }
 
 void
@@ -387,6 +255,13 @@ CsmaLinkHandler(const json& jLink, ConfigJsonHelper& helper)
 {
     // 必需字段
     uint32_t linkId = jLink.at("linkId").get<uint32_t>();
+
+    // 合并的交换段由第一条链路整体安装，其余链路不再单独安装
+    const SwitchedSegments::Segment* segment =
+        helper.segments ? helper.segments->FindByLink(linkId) : nullptr;
+    if (segment && segment->leaderLinkId != linkId)
+        return;
+
     CsmaHelper csma;
 
     /* ===============================
@@ -454,6 +329,34 @@ CsmaLinkHandler(const json& jLink, ConfigJsonHelper& helper)
         }
     }
 
+    /* ===============================
+     * Collapsed switch segment
+     * =============================== */
+    if (segment)
+    {
+        // 端点之间原为 端点-交换机-端点 两跳，保留两段传播时延
+        if (jLink.contains("channel") && jLink.at("channel").contains("delay"))
+            csma.SetChannelAttribute(
+                "Delay",
+                TimeValue(Time(jLink.at("channel").at("delay").get<std::string>()) * 2));
+
+        NodeContainer nodes;
+        for (const auto& [nodeId, segmentLinkId] : segment->endpoints)
+            nodes.Add(Names::Find<Node>("node" + std::to_string(nodeId)));
+        NetDeviceContainer devices = csma.Install(nodes);
+
+        // 设备和信道仍按原链路命名，地址、路由和应用的引用不变
+        for (uint32_t i = 0; i < devices.GetN(); ++i)
+        {
+            const auto& [nodeId, segmentLinkId] = segment->endpoints[i];
+            Names::Add("node" + std::to_string(nodeId) + "-link" + std::to_string(segmentLinkId),
+                       devices.Get(i));
+            Names::Add("link" + std::to_string(segmentLinkId) + "-channel",
+                       devices.Get(0)->GetChannel());
+        }
+        return;
+    }
+
     /* ===============================
      * Nodes (required)
      * =============================== */
@@ -470,7 +373,7 @@ CsmaLinkHandler(const json& jLink, ConfigJsonHelper& helper)
     NetDeviceContainer devices = csma.Install(nodes);
 
     /* ===============================
-     * Name NetDevices
+     * Name NetDevices / Channel
      * =============================== */
     for (uint32_t i = 0; i < devices.GetN(); ++i)
     {
@@ -478,6 +381,7 @@ CsmaLinkHandler(const json& jLink, ConfigJsonHelper& helper)
         std::string nodeName = Names::FindName(dev->GetNode());
         Names::Add(nodeName + "-link" + std::to_string(linkId), dev);
     }
+    Names::Add("link" + std::to_string(linkId) + "-channel", devices.Get(0)->GetChannel());
 }
 
 void
@@ -491,6 +395,10 @@ InternetHandler(const json& jInternet, ConfigJsonHelper& helper)
     bool enableGlobalRouting = false;
     enableGlobalRouting = jInternet.at("enableGlobalRouting").get<bool>();
 
+    const bool enableNixRouting = jInternet.value("enableNixRouting", false);
+    if (enableGlobalRouting && enableNixRouting)
+        throw std::invalid_argument("enableGlobalRouting and enableNixRouting are exclusive");
+
     if (enableGlobalRouting)
     {
         helper.enableGlobalRouting = true;
@@ -500,20 +408,44 @@ InternetHandler(const json& jInternet, ConfigJsonHelper& helper)
         return;
     }
 
+    /* ===============================
+     * Nix-vector routing (optional)
+     * =============================== */
+    // 与全局路由一样作用于整个网络、不读路由文件，但不预先填表：
+    // 路径在首次发送时按需计算并按目的地缓存
+    if (enableNixRouting)
+    {
+        stack.SetRoutingHelper(Ipv4NixVectorHelper());
+        stack.SetRoutingHelper(Ipv6NixVectorHelper());
+        stack.InstallAll();
+        return;
+    }
+
     /* ===============================
      * Per-node routing configuration
      * =============================== */
     const auto& jIpv4RoutingProtocols = helper.handleJson[JsonDomain::Ipv4RoutingProtocol];
     const auto& jIpv6RoutingProtocols = helper.handleJson[JsonDomain::Ipv6RoutingProtocol];
 
-    std::set<uint32_t> allNodeIds;
+    // nodeId -> 该节点的路由条目（按文件顺序），避免每个节点都扫描全部条目
+    std::map<uint32_t, std::vector<const json*>> ipv4ByNode;
+    std::map<uint32_t, std::vector<const json*>> ipv6ByNode;
     for (const auto& j : jIpv4RoutingProtocols)
-        allNodeIds.insert(j.at("nodeId").get<uint32_t>());
+        ipv4ByNode[j.at("nodeId").get<uint32_t>()].push_back(&j);
     for (const auto& j : jIpv6RoutingProtocols)
-        allNodeIds.insert(j.at("nodeId").get<uint32_t>());
+        ipv6ByNode[j.at("nodeId").get<uint32_t>()].push_back(&j);
+
+    std::set<uint32_t> allNodeIds;
+    for (const auto& [nodeId, entries] : ipv4ByNode)
+        allNodeIds.insert(nodeId);
+    for (const auto& [nodeId, entries] : ipv6ByNode)
+        allNodeIds.insert(nodeId);
 
     for (uint32_t nodeId : allNodeIds)
     {
+        if (!helper.IsNodeInstalled(nodeId))
+            continue;
+
         Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
         NS_ASSERT(node);
 
@@ -521,12 +453,9 @@ InternetHandler(const json& jInternet, ConfigJsonHelper& helper)
         helper.ipv6List = std::make_unique<Ipv6ListRoutingHelper>();
 
         /* ---------- IPv4 routing ---------- */
-        for (const auto& j : jIpv4RoutingProtocols)
+        for (const json* j : ipv4ByNode[nodeId])
         {
-            if (j.at("nodeId").get<uint32_t>() != nodeId)
-                continue;
-
-            for (const auto& routeConf : j.at("ipv4RoutingList"))
+            for (const auto& routeConf : j->at("ipv4RoutingList"))
             {
                 auto fn = helper.GetRegistry(JsonDomain::Ipv4RoutingProtocol,
                                              routeConf.at("type").get<std::string>());
@@ -535,12 +464,9 @@ InternetHandler(const json& jInternet, ConfigJsonHelper& helper)
         }
 
         /* ---------- IPv6 routing ---------- */
-        for (const auto& j : jIpv6RoutingProtocols)
+        for (const json* j : ipv6ByNode[nodeId])
         {
-            if (j.at("nodeId").get<uint32_t>() != nodeId)
-                continue;
-
-            for (const auto& routeConf : j.at("ipv6RoutingList"))
+            for (const auto& routeConf : j->at("ipv6RoutingList"))
             {
                 auto fn = helper.GetRegistry(JsonDomain::Ipv6RoutingProtocol,
                                              routeConf.at("type").get<std::string>());
@@ -573,6 +499,9 @@ Ipv4NetworkHandler(const json& jNetwork, ConfigJsonHelper& helper)
         for (const auto& f : jNetwork.at("fixed"))
         {
             const auto& devId = f.at("netDeviceId");
+            if (!helper.IsDeviceInstalled(devId.at("nodeId").get<uint32_t>(),
+                                          devId.at("linkId").get<uint32_t>()))
+                continue;
 
             Ptr<Node> node =
                 Names::Find<Node>("node" + std::to_string(devId.at("nodeId").get<uint32_t>()));
@@ -602,6 +531,15 @@ Ipv4NetworkHandler(const json& jNetwork, ConfigJsonHelper& helper)
         NetDeviceContainer devs;
         for (const auto& devId : jNetwork.at("netDeviceIds"))
         {
+            if (!helper.IsDeviceInstalled(devId.at("nodeId").get<uint32_t>(),
+                                          devId.at("linkId").get<uint32_t>()))
+            {
+                // 未安装的设备（其他 rank 或子集之外）：跳过但占用一个地址，编址与完整拓扑一致
+                address.Assign(devs);
+                devs = NetDeviceContainer();
+                address.NewAddress();
+                continue;
+            }
             Ptr<NetDevice> dev = Names::Find<NetDevice>(
                 "node" + std::to_string(devId.at("nodeId").get<uint32_t>()) + "-link" +
                 std::to_string(devId.at("linkId").get<uint32_t>()));
@@ -624,6 +562,9 @@ Ipv6NetworkHandler(const json& jNetwork, ConfigJsonHelper& helper)
         for (const auto& f : jNetwork.at("fixed"))
         {
             const auto& devId = f.at("netDeviceId");
+            if (!helper.IsDeviceInstalled(devId.at("nodeId").get<uint32_t>(),
+                                          devId.at("linkId").get<uint32_t>()))
+                continue;
 
             Ptr<Node> node =
                 Names::Find<Node>("node" + std::to_string(devId.at("nodeId").get<uint32_t>()));
@@ -653,6 +594,10 @@ Ipv6NetworkHandler(const json& jNetwork, ConfigJsonHelper& helper)
         NetDeviceContainer devs;
         for (const auto& devId : jNetwork.at("netDeviceIds"))
         {
+            // IPv6 自动地址由 MAC 生成，跳过未安装的设备不影响其余设备
+            if (!helper.IsDeviceInstalled(devId.at("nodeId").get<uint32_t>(),
+                                          devId.at("linkId").get<uint32_t>()))
+                continue;
             Ptr<NetDevice> dev = Names::Find<NetDevice>(
                 "node" + std::to_string(devId.at("nodeId").get<uint32_t>()) + "-link" +
                 std::to_string(devId.at("linkId").get<uint32_t>()));
@@ -697,6 +642,9 @@ Ipv4StaticHandler(const json& jRouting, ConfigJsonHelper& helper)
             const std::string mask = route.at("mask").get<std::string>();
             const std::string nextHop = route.at("nextHop").get<std::string>();
             uint32_t nextLinkId = route.at("nextLinkId").get<uint32_t>();
+            // 出接口所在链路未安装（子集之外）或交换机已合并时没有对应接口
+            if (!helper.IsDeviceInstalled(nodeId, nextLinkId))
+                continue;
             Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(nodeId) + "-link" +
                                                         std::to_string(nextLinkId));
             uint32_t nextIf = ipv4->GetInterfaceForDevice(dev);
@@ -743,6 +691,8 @@ Ipv6StaticHandler(const json& jRouting, ConfigJsonHelper& helper)
             uint32_t prefixLength = route.at("prefixLength").get<uint32_t>();
             const std::string nextHop = route.at("nextHop").get<std::string>();
             uint32_t nextLinkId = route.at("nextLinkId").get<uint32_t>();
+            if (!helper.IsDeviceInstalled(nodeId, nextLinkId))
+                continue;
 
             Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(nodeId) + "-link" +
                                                         std::to_string(nextLinkId));
@@ -757,6 +707,27 @@ Ipv6StaticHandler(const json& jRouting, ConfigJsonHelper& helper)
     }
 }
 
+void
+Ipv4NixHandler(const json& jRouting, ConfigJsonHelper& helper)
+{
+    // 只在 Internet 阶段登记；路径按需计算，没有逐节点的路由配置
+    if (helper.status == JsonDomain::Internet)
+    {
+        Ipv4NixVectorHelper nix;
+        helper.ipv4List->Add(nix, jRouting.at("priority").get<uint32_t>());
+    }
+}
+
+void
+Ipv6NixHandler(const json& jRouting, ConfigJsonHelper& helper)
+{
+    if (helper.status == JsonDomain::Internet)
+    {
+        Ipv6NixVectorHelper nix;
+        helper.ipv6List->Add(nix, jRouting.at("priority").get<uint32_t>());
+    }
+}
+
 void
 OlsrHandler(const json& jRouting, ConfigJsonHelper& helper)
 {
@@ -813,125 +784,136 @@ OlsrHandler(const json& jRouting, ConfigJsonHelper& helper)
     }
 }
 
-void
-ConstantPositionMobilityHandler(const json& jMobility, ConfigJsonHelper& helper)
+namespace
 {
-    uint32_t nodeId = jMobility.at("nodeId").get<uint32_t>();
-    Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
-    NS_ASSERT(node);
-
-    double x = 0.0;
-    double y = 0.0;
-    double z = 0.0;
-
-    const auto& jPos = jMobility.at("position");
+Vector
+DecodePosition(const json& jPos)
+{
+    Vector v(0.0, 0.0, 0.0);
     for (auto it = jPos.begin(); it != jPos.end(); ++it)
     {
         const std::string& key = it.key();
         const auto& val = it.value();
 
         if (key == "x")
-            x = val.get<double>();
+            v.x = val.get<double>();
         else if (key == "y")
-            y = val.get<double>();
+            v.y = val.get<double>();
         else if (key == "z")
-            z = val.get<double>();
+            v.z = val.get<double>();
     }
-    MobilityHelper mob;
-    mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mob.Install(node);
-
-    node->GetObject<MobilityModel>()->SetPosition(Vector(x, y, z));
+    return v;
 }
 
-void
-WaypointMobilityHandler(const json& jMobility, ConfigJsonHelper& helper)
+Ptr<Node>
+FindNode(uint32_t nodeId)
 {
-    uint32_t nodeId = jMobility.at("nodeId").get<uint32_t>();
     Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
     NS_ASSERT(node);
+    return node;
+}
+} // namespace
 
-    /* ---------- 初始位置 ---------- */
-    double x = 0.0;
-    double y = 0.0;
-    double z = 0.0;
+MobilityConfig
+DecodeMobility(const json& jMobility)
+{
+    MobilityConfig config;
+    config.nodeId = jMobility.at("nodeId").get<uint32_t>();
+    config.position = DecodePosition(jMobility.at("position"));
 
-    const auto& jPos = jMobility.at("position");
-    for (auto it = jPos.begin(); it != jPos.end(); ++it)
+    if (!jMobility.contains("waypoints"))
+        return config;
+    for (const auto& p : jMobility.at("waypoints"))
     {
-        const std::string& key = it.key();
-        const auto& val = it.value();
-
-        if (key == "x")
-            x = val.get<double>();
-        else if (key == "y")
-            y = val.get<double>();
-        else if (key == "z")
-            z = val.get<double>();
+        double t = 0.0;
+        for (auto it = p.begin(); it != p.end(); ++it)
+        {
+            if (it.key() == "time")
+                t = it.value().get<double>();
+        }
+        config.waypoints.emplace_back(Seconds(t), DecodePosition(p));
     }
+    return config;
+}
+
+void
+ApplyConstantPositionMobility(const MobilityConfig& config, ConfigJsonHelper& helper)
+{
+    Ptr<Node> node = FindNode(config.nodeId);
+
+    MobilityHelper mob;
+    mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mob.Install(node);
+
+    node->GetObject<MobilityModel>()->SetPosition(config.position);
+}
+
+void
+ApplyWaypointMobility(const MobilityConfig& config, ConfigJsonHelper& helper)
+{
+    Ptr<Node> node = FindNode(config.nodeId);
 
+    /* ---------- 初始位置 ---------- */
     MobilityHelper mob;
     mob.SetMobilityModel("ns3::WaypointMobilityModel");
     mob.Install(node);
 
-    node->GetObject<MobilityModel>()->SetPosition(Vector(x, y, z));
+    node->GetObject<MobilityModel>()->SetPosition(config.position);
 
     /* ---------- Waypoints ---------- */
     Ptr<WaypointMobilityModel> wpm = node->GetObject<WaypointMobilityModel>();
     NS_ASSERT(wpm);
 
-    const auto& waypoints = jMobility.at("waypoints");
-    for (const auto& p : waypoints)
-    {
-        double t = 0.0;
-        double wx = 0.0;
-        double wy = 0.0;
-        double wz = 0.0;
-
-        for (auto it = p.begin(); it != p.end(); ++it)
-        {
-            const std::string& key = it.key();
-            const auto& val = it.value();
-
-            if (key == "time")
-                t = val.get<double>();
-            else if (key == "x")
-                wx = val.get<double>();
-            else if (key == "y")
-                wy = val.get<double>();
-            else if (key == "z")
-                wz = val.get<double>();
-        }
+    for (const auto& waypoint : config.waypoints)
+        wpm->AddWaypoint(waypoint);
+}
 
-        wpm->AddWaypoint(Waypoint(Seconds(t), Vector(wx, wy, wz)));
-    }
+void
+ConstantPositionMobilityHandler(const json& jMobility, ConfigJsonHelper& helper)
+{
+    ApplyConstantPositionMobility(DecodeMobility(jMobility), helper);
 }
 
 void
-UdpEchoClientHandler(const json& jApplication, ConfigJsonHelper& helper)
+WaypointMobilityHandler(const json& jMobility, ConfigJsonHelper& helper)
 {
-    uint32_t nodeId = jApplication.at("nodeId").get<uint32_t>();
-    Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
-    NS_ASSERT(node);
+    ApplyWaypointMobility(DecodeMobility(jMobility), helper);
+}
 
-    std::string start;
-    std::string stop;
+ApplicationConfig
+DecodeApplication(const json& jApplication)
+{
+    ApplicationConfig config;
+    config.nodeId = jApplication.at("nodeId").get<uint32_t>();
+    config.applicationId = jApplication.at("applicationId").get<uint32_t>();
 
     for (auto it = jApplication.begin(); it != jApplication.end(); ++it)
     {
-        if (it.key() == "startTime")
-            start = it.value().get<std::string>();
-        else if (it.key() == "stopTime")
-            stop = it.value().get<std::string>();
+        const std::string& key = it.key();
+        const auto& val = it.value();
+
+        if (key == "startTime")
+            config.start = Time(val.get<std::string>());
+        else if (key == "stopTime")
+            config.stop = Time(val.get<std::string>());
+        else if (key == "maxPackets")
+            config.maxPackets = val.get<uint32_t>();
+        else if (key == "interval")
+            config.interval = Time(val.get<std::string>());
+        else if (key == "packetSize")
+            config.packetSize = val.get<uint32_t>();
+        else if (key == "dataRate")
+            config.dataRate = DataRate(val.get<std::string>());
+        else if (key == "protocol")
+            config.protocol = val.get<std::string>();
+        else if (key == "profile")
+            config.profile = val.get<std::string>();
+        else if (key == "counters")
+            config.counters = Time(val.get<std::string>());
     }
 
     const auto& jSocket = jApplication.at("socket");
-
-    std::string socketType;
-    uint16_t port = 0;
-    uint32_t remoteNodeId = 0;
-    bool hasLinkId = false;
-    uint32_t linkId = 0;
+    AppSocketConfig& socket = config.socket;
 
     for (auto it = jSocket.begin(); it != jSocket.end(); ++it)
     {
@@ -939,289 +921,279 @@ UdpEchoClientHandler(const json& jApplication, ConfigJsonHelper& helper)
         const auto& val = it.value();
 
         if (key == "type")
-            socketType = val.get<std::string>();
+            socket.ipv6 = val.get<std::string>() == "ipv6";
         else if (key == "port")
-            port = val.get<uint16_t>();
+            socket.port = val.get<uint16_t>();
         else if (key == "netDeviceId")
         {
             for (auto nit = val.begin(); nit != val.end(); ++nit)
             {
                 if (nit.key() == "nodeId")
-                    remoteNodeId = nit.value().get<uint32_t>();
+                    socket.remoteNodeId = nit.value().get<uint32_t>();
                 else if (nit.key() == "linkId")
                 {
-                    hasLinkId = true;
-                    linkId = nit.value().get<uint32_t>();
+                    socket.hasLinkId = true;
+                    socket.linkId = nit.value().get<uint32_t>();
                 }
             }
         }
     }
+    return config;
+}
 
-    uint32_t maxPackets = 0;
-    std::string interval;
-    uint32_t packetSize = 0;
+namespace
+{
+// 远端节点（指定 linkId 时为该链路上的接口，否则为接口 1）的地址和端口
+Address
+RemoteAddress(const AppSocketConfig& socket)
+{
+    Ptr<Node> remote = FindNode(socket.remoteNodeId);
+    Ptr<NetDevice> dev;
+    if (socket.hasLinkId)
+    {
+        dev = Names::Find<NetDevice>("node" + std::to_string(socket.remoteNodeId) + "-link" +
+                                     std::to_string(socket.linkId));
+    }
 
-    for (auto it = jApplication.begin(); it != jApplication.end(); ++it)
-    {
-        const std::string& key = it.key();
-        const auto& val = it.value();
-
-        if (key == "maxPackets")
-            maxPackets = val.get<uint32_t>();
-        else if (key == "interval")
-            interval = val.get<std::string>();
-        else if (key == "packetSize")
-            packetSize = val.get<uint32_t>();
-    }
-
-    Ptr<Application> app;
-
-    Ptr<Node> remote = Names::Find<Node>("node" + std::to_string(remoteNodeId));
-    NS_ASSERT(remote);
-
-    if (socketType == "ipv4")
+    if (!socket.ipv6)
     {
         Ptr<Ipv4> ipv4 = remote->GetObject<Ipv4>();
-        int32_t iface = 1;
-
-        if (hasLinkId)
-        {
-            Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(remoteNodeId) +
-                                                        "-link" + std::to_string(linkId));
-            iface = ipv4->GetInterfaceForDevice(dev);
-        }
-
-        Ipv4Address dst = ipv4->GetAddress(iface, 0).GetLocal();
-        UdpEchoClientHelper client(InetSocketAddress(dst, port));
-        client.SetAttribute("MaxPackets", UintegerValue(maxPackets));
-        client.SetAttribute("Interval", TimeValue(Time(interval)));
-        client.SetAttribute("PacketSize", UintegerValue(packetSize));
-        app = client.Install(node).Get(0);
+        int32_t iface = dev ? ipv4->GetInterfaceForDevice(dev) : 1;
+        return InetSocketAddress(ipv4->GetAddress(iface, 0).GetLocal(), socket.port);
     }
-    else if (socketType == "ipv6")
-    {
-        Ptr<Ipv6> ipv6 = remote->GetObject<Ipv6>();
-        int32_t iface = 1;
-
-        if (hasLinkId)
-        {
-            Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(remoteNodeId) +
-                                                        "-link" + std::to_string(linkId));
-            iface = ipv6->GetInterfaceForDevice(dev);
-        }
+    Ptr<Ipv6> ipv6 = remote->GetObject<Ipv6>();
+    int32_t iface = dev ? ipv6->GetInterfaceForDevice(dev) : 1;
+    return Inet6SocketAddress(ipv6->GetAddress(iface, 0).GetAddress(), socket.port);
+}
 
-        Ipv6Address dst = ipv6->GetAddress(iface, 0).GetAddress();
-        UdpEchoClientHelper client(Inet6SocketAddress(dst, port));
-        client.SetAttribute("MaxPackets", UintegerValue(maxPackets));
-        client.SetAttribute("Interval", TimeValue(Time(interval)));
-        client.SetAttribute("PacketSize", UintegerValue(packetSize));
-        app = client.Install(node).Get(0);
-    }
+void
+FinishApplication(const ApplicationConfig& config, Ptr<Application> app, ConfigJsonHelper& helper)
+{
+    app->SetStartTime(config.start);
+    app->SetStopTime(config.stop);
+    const std::string name =
+        "node" + std::to_string(config.nodeId) + "-app" + std::to_string(config.applicationId);
+    Names::Add(name, app);
 
-    app->SetStartTime(Time(start));
-    app->SetStopTime(Time(stop));
-    uint32_t appId = jApplication.at("applicationId").get<uint32_t>();
-    Names::Add("node" + std::to_string(nodeId) + "-app" + std::to_string(appId), app);
+    if (config.counters.IsZero())
+        return;
+    if (!config.counters.IsStrictlyPositive())
+        throw std::invalid_argument(name + ": counters interval must be > 0");
+    if (!helper.appCounters)
+        helper.appCounters = std::make_shared<ApplicationCounterSampler>();
+    if (!helper.appCounters->Add(name, app, config.counters, config.start, config.stop))
+        throw std::invalid_argument(name + ": counters supports PacketSink, OnOff and "
+                                           "UdpEchoClient only");
 }
+} // namespace
 
 void
-UdpEchoServerHandler(const json& jApplication, ConfigJsonHelper& helper)
+ApplyUdpEchoClient(const ApplicationConfig& config, ConfigJsonHelper& helper)
 {
-    uint32_t nodeId = jApplication.at("nodeId").get<uint32_t>();
-    Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
-    NS_ASSERT(node);
+    UdpEchoClientHelper client(RemoteAddress(config.socket));
+    client.SetAttribute("MaxPackets", UintegerValue(config.maxPackets));
+    client.SetAttribute("Interval", TimeValue(config.interval));
+    client.SetAttribute("PacketSize", UintegerValue(config.packetSize));
+    FinishApplication(config, client.Install(FindNode(config.nodeId)).Get(0), helper);
+}
 
-    std::string start;
-    std::string stop;
-    uint16_t port = 0;
+void
+ApplyUdpEchoServer(const ApplicationConfig& config, ConfigJsonHelper& helper)
+{
+    UdpEchoServerHelper server(config.socket.port);
+    FinishApplication(config, server.Install(FindNode(config.nodeId)).Get(0), helper);
+}
 
-    for (auto it = jApplication.begin(); it != jApplication.end(); ++it)
+void
+ApplyOnOff(const ApplicationConfig& config, ConfigJsonHelper& helper)
+{
+    if (config.profile.empty())
     {
-        if (it.key() == "startTime")
-            start = it.value().get<std::string>();
-        else if (it.key() == "stopTime")
-            stop = it.value().get<std::string>();
-        else if (it.key() == "socket")
-        {
-            for (auto sit = it.value().begin(); sit != it.value().end(); ++sit)
-            {
-                if (sit.key() == "port")
-                    port = sit.value().get<uint16_t>();
-            }
-        }
+        OnOffHelper onoff("ns3::UdpSocketFactory", RemoteAddress(config.socket));
+        onoff.SetAttribute("DataRate", DataRateValue(config.dataRate));
+        onoff.SetAttribute("PacketSize", UintegerValue(config.packetSize));
+        FinishApplication(config, onoff.Install(FindNode(config.nodeId)).Get(0), helper);
+        return;
     }
 
-    UdpEchoServerHelper server(port);
-    Ptr<Application> app = server.Install(node).Get(0);
-    app->SetStartTime(Time(start));
-    app->SetStopTime(Time(stop));
-    uint32_t appId = jApplication.at("applicationId").get<uint32_t>();
-    Names::Add("node" + std::to_string(nodeId) + "-app" + std::to_string(appId), app);
+    // profile 已设置速率、包长和开关时间，元素中写出（非 0）的项覆盖之
+    OnOffHelper onoff = GetProfiles(helper).FindOnOff(config.profile);
+    onoff.SetAttribute("Remote", AddressValue(RemoteAddress(config.socket)));
+    if (config.dataRate.GetBitRate() > 0)
+        onoff.SetAttribute("DataRate", DataRateValue(config.dataRate));
+    if (config.packetSize)
+        onoff.SetAttribute("PacketSize", UintegerValue(config.packetSize));
+    FinishApplication(config, onoff.Install(FindNode(config.nodeId)).Get(0), helper);
 }
 
 void
-OnOffHandler(const json& jApplication, ConfigJsonHelper& helper)
+ApplyPacketSink(const ApplicationConfig& config, ConfigJsonHelper& helper)
 {
-    uint32_t nodeId = jApplication.at("nodeId").get<uint32_t>();
-    Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
-    NS_ASSERT(node);
-
-    std::string start;
-    std::string stop;
-    std::string dataRate;
-    uint32_t packetSize = 0;
+    const uint16_t port = config.socket.port;
+    PacketSinkHelper sink(config.protocol,
+                          config.socket.ipv6
+                              ? Address(Inet6SocketAddress(Ipv6Address::GetAny(), port))
+                              : Address(InetSocketAddress(Ipv4Address::GetAny(), port)));
+    FinishApplication(config, sink.Install(FindNode(config.nodeId)).Get(0), helper);
+}
 
-    for (auto it = jApplication.begin(); it != jApplication.end(); ++it)
-    {
-        const std::string& key = it.key();
-        const auto& val = it.value();
+void
+UdpEchoClientHandler(const json& jApplication, ConfigJsonHelper& helper)
+{
+    ApplyUdpEchoClient(DecodeApplication(jApplication), helper);
+}
 
-        if (key == "startTime")
-            start = val.get<std::string>();
-        else if (key == "stopTime")
-            stop = val.get<std::string>();
-        else if (key == "dataRate")
-            dataRate = val.get<std::string>();
-        else if (key == "packetSize")
-            packetSize = val.get<uint32_t>();
-    }
+void
+UdpEchoServerHandler(const json& jApplication, ConfigJsonHelper& helper)
+{
+    ApplyUdpEchoServer(DecodeApplication(jApplication), helper);
+}
 
-    const auto& jSocket = jApplication.at("socket");
+void
+OnOffHandler(const json& jApplication, ConfigJsonHelper& helper)
+{
+    ApplyOnOff(DecodeApplication(jApplication), helper);
+}
 
-    std::string socketType;
-    uint16_t port = 0;
-    uint32_t remoteNodeId = 0;
-    bool hasLinkId = false;
-    uint32_t linkId = 0;
+void
+PacketSinkHandler(const json& jApplication, ConfigJsonHelper& helper)
+{
+    ApplyPacketSink(DecodeApplication(jApplication), helper);
+}
 
-    for (auto it = jSocket.begin(); it != jSocket.end(); ++it)
+TimelineConfig
+DecodeTimeline(const json& jTimeline)
+{
+    TimelineConfig config;
+    config.changes.reserve(jTimeline.size());
+    for (const auto& jChange : jTimeline)
     {
-        const std::string& key = it.key();
-        const auto& val = it.value();
+        TimelineChange change;
+        change.time = Time(jChange.at("time").get<std::string>());
 
-        if (key == "type")
-            socketType = val.get<std::string>();
-        else if (key == "port")
-            port = val.get<uint16_t>();
-        else if (key == "netDeviceId")
+        if (jChange.contains("path"))
         {
-            for (auto nit = val.begin(); nit != val.end(); ++nit)
+            // Config 路径的最后一段是属性名，同 Config::Set
+            const std::string path = jChange.at("path").get<std::string>();
+            const auto slash = path.rfind('/');
+            if (slash == std::string::npos || slash + 1 == path.size())
+                throw std::invalid_argument("timeline: bad attribute path: " + path);
+            change.configPath = true;
+            change.path = path.substr(0, slash);
+            change.attribute = path.substr(slash + 1);
+        }
+        else
+        {
+            if (jChange.contains("name"))
+                change.path = jChange.at("name").get<std::string>();
+            else
             {
-                if (nit.key() == "nodeId")
-                    remoteNodeId = nit.value().get<uint32_t>();
-                else if (nit.key() == "linkId")
-                {
-                    hasLinkId = true;
-                    linkId = nit.value().get<uint32_t>();
-                }
+                // 按安装时注册的名字定位：设备 / 信道 / 应用 / 节点
+                const auto& jTarget = jChange.at("target");
+                if (jTarget.contains("nodeId"))
+                    change.nodeId = jTarget.at("nodeId").get<uint32_t>();
+                if (jTarget.contains("linkId"))
+                    change.linkId = jTarget.at("linkId").get<uint32_t>();
+
+                if (change.nodeId && change.linkId)
+                    change.path = "node" + std::to_string(*change.nodeId) + "-link" +
+                                  std::to_string(*change.linkId);
+                else if (change.linkId)
+                    change.path = "link" + std::to_string(*change.linkId) + "-channel";
+                else if (change.nodeId && jTarget.contains("applicationId"))
+                    change.path = "node" + std::to_string(*change.nodeId) + "-app" +
+                                  std::to_string(jTarget.at("applicationId").get<uint32_t>());
+                else if (change.nodeId)
+                    change.path = "node" + std::to_string(*change.nodeId);
+                else
+                    throw std::invalid_argument("timeline: target needs nodeId or linkId");
             }
+            change.attribute = jChange.at("attribute").get<std::string>();
         }
+
+        // 非字符串的值（数字、布尔）按 JSON 文本交给属性的 checker 解析
+        const auto& jValue = jChange.at("value");
+        change.value = jValue.is_string() ? jValue.get<std::string>() : jValue.dump();
+        config.changes.push_back(std::move(change));
     }
+    return config;
+}
 
-    Ptr<Application> app;
-    Ptr<Node> remote = Names::Find<Node>("node" + std::to_string(remoteNodeId));
-    NS_ASSERT(remote);
+void
+ApplyTimeline(const TimelineConfig& config, ConfigJsonHelper& helper)
+{
+    Ptr<AttributeTimeline> timeline = Create<AttributeTimeline>();
 
-    if (socketType == "ipv4")
-    {
-        Ptr<Ipv4> ipv4 = remote->GetObject<Ipv4>();
-        int32_t iface = 1;
+    // 同类型同属性只查找一次，同一 checker 下相同的值只解析一次，各条修改共享
+    std::map<std::pair<TypeId, std::string>, TypeId::AttributeInformation> infos;
+    std::map<std::pair<const AttributeChecker*, std::string>, Ptr<const AttributeValue>> values;
 
-        if (hasLinkId)
+    auto add = [&](const TimelineChange& change, Ptr<Object> object) {
+        const TypeId tid = object->GetInstanceTypeId();
+        auto it = infos.find({tid, change.attribute});
+        if (it == infos.end())
         {
-            Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(remoteNodeId) +
-                                                        "-link" + std::to_string(linkId));
-            iface = ipv4->GetInterfaceForDevice(dev);
+            TypeId::AttributeInformation info;
+            if (!tid.LookupAttributeByName(change.attribute, &info))
+                throw std::invalid_argument("timeline: " + tid.GetName() + " has no attribute " +
+                                            change.attribute);
+            if (!(info.flags & TypeId::ATTR_SET) || !info.accessor->HasSetter())
+                throw std::invalid_argument("timeline: attribute " + tid.GetName() +
+                                            "::" + change.attribute + " is not settable");
+            it = infos.emplace(std::make_pair(tid, change.attribute), info).first;
         }
+        const TypeId::AttributeInformation& info = it->second;
 
-        Ipv4Address dst = ipv4->GetAddress(iface, 0).GetLocal();
-        OnOffHelper onoff("ns3::UdpSocketFactory", InetSocketAddress(dst, port));
-        onoff.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-        onoff.SetAttribute("PacketSize", UintegerValue(packetSize));
-        app = onoff.Install(node).Get(0);
-    }
-    else if (socketType == "ipv6")
+        auto& value = values[{PeekPointer(info.checker), change.value}];
+        if (!value)
+        {
+            value = info.checker->CreateValidValue(StringValue(change.value));
+            if (!value)
+                throw std::invalid_argument("timeline: invalid value '" + change.value +
+                                            "' for " + tid.GetName() + "::" + change.attribute);
+        }
+        timeline->Add(change.time, object, info.accessor, value);
+    };
+
+    for (const auto& change : config.changes)
     {
-        Ptr<Ipv6> ipv6 = remote->GetObject<Ipv6>();
-        int32_t iface = 1;
+        // 目标不在本进程 / 子集中安装
+        if ((change.nodeId && !helper.IsNodeInstalled(*change.nodeId)) ||
+            (change.linkId && !helper.IsLinkInstalled(*change.linkId)) ||
+            (change.nodeId && change.linkId &&
+             !helper.IsDeviceInstalled(*change.nodeId, *change.linkId)))
+            continue;
 
-        if (hasLinkId)
+        if (change.configPath)
         {
-            Ptr<NetDevice> dev = Names::Find<NetDevice>("node" + std::to_string(remoteNodeId) +
-                                                        "-link" + std::to_string(linkId));
-            iface = ipv6->GetInterfaceForDevice(dev);
+            const Config::MatchContainer matches = Config::LookupMatches(change.path);
+            if (matches.GetN() == 0)
+                NS_LOG_WARN("timeline: no object matches " << change.path);
+            for (std::size_t i = 0; i < matches.GetN(); ++i)
+                add(change, matches.Get(i));
+            continue;
         }
 
-        Ipv6Address dst = ipv6->GetAddress(iface, 0).GetAddress();
-        OnOffHelper onoff("ns3::UdpSocketFactory", Inet6SocketAddress(dst, port));
-        onoff.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-        onoff.SetAttribute("PacketSize", UintegerValue(packetSize));
-        app = onoff.Install(node).Get(0);
+        Ptr<Object> object = Names::Find<Object>(change.path);
+        if (!object)
+        {
+            // 按名字给出的目标在划分 / 子集下可能不在本进程
+            if (!change.nodeId && !change.linkId && (helper.partition || helper.subset))
+                continue;
+            throw std::invalid_argument("timeline: object not found: " + change.path);
+        }
+        add(change, object);
     }
 
-    app->SetStartTime(Time(start));
-    app->SetStopTime(Time(stop));
-    uint32_t appId = jApplication.at("applicationId").get<uint32_t>();
-    Names::Add("node" + std::to_string(nodeId) + "-app" + std::to_string(appId), app);
+    timeline->Start();
+    NS_LOG_INFO("timeline: " << timeline->GetNChanges() << " changes in "
+                             << timeline->GetNBatches() << " events");
 }
 
 void
-PacketSinkHandler(const json& jApplication, ConfigJsonHelper& helper)
+TimelineHandler(const json& jTimeline, ConfigJsonHelper& helper)
 {
-    uint32_t nodeId = jApplication.at("nodeId").get<uint32_t>();
-    Ptr<Node> node = Names::Find<Node>("node" + std::to_string(nodeId));
-    NS_ASSERT(node);
-
-    std::string start;
-    std::string stop;
-    std::string protocol;
-
-    for (auto it = jApplication.begin(); it != jApplication.end(); ++it)
-    {
-        const std::string& key = it.key();
-        const auto& val = it.value();
-
-        if (key == "startTime")
-            start = val.get<std::string>();
-        else if (key == "stopTime")
-            stop = val.get<std::string>();
-        else if (key == "protocol")
-            protocol = val.get<std::string>();
-    }
-
-    const auto& jSocket = jApplication.at("socket");
-
-    std::string socketType;
-    uint16_t port = 0;
-
-    for (auto it = jSocket.begin(); it != jSocket.end(); ++it)
-    {
-        const std::string& key = it.key();
-        const auto& val = it.value();
-
-        if (key == "type")
-            socketType = val.get<std::string>();
-        else if (key == "port")
-            port = val.get<uint16_t>();
-    }
-
-    Ptr<Application> app;
-
-    if (socketType == "ipv4")
-    {
-        PacketSinkHelper sink(protocol, InetSocketAddress(Ipv4Address::GetAny(), port));
-        app = sink.Install(node).Get(0);
-    }
-    else if (socketType == "ipv6")
-    {
-        PacketSinkHelper sink(protocol, Inet6SocketAddress(Ipv6Address::GetAny(), port));
-        app = sink.Install(node).Get(0);
-    }
-
-    app->SetStartTime(Time(start));
-    app->SetStopTime(Time(stop));
-    uint32_t appId = jApplication.at("applicationId").get<uint32_t>();
-    Names::Add("node" + std::to_string(nodeId) + "-app" + std::to_string(appId), app);
+    ApplyTimeline(DecodeTimeline(jTimeline), helper);
 }
 
 LogLevel
@@ -1267,7 +1239,7 @@ ParseLogLevel(const std::string& s)
 }
 
 void
-DefaultSink(Ptr<PcapFileWrapper> file, Ptr<const Packet> packet)
+DefaultSink(Ptr<AsyncPcapWriter> file, Ptr<const Packet> packet)
 {
     if (!file || !packet)
     {
@@ -1277,7 +1249,7 @@ DefaultSink(Ptr<PcapFileWrapper> file, Ptr<const Packet> packet)
 }
 
 void
-WifiPcapSink(Ptr<PcapFileWrapper> file,
+WifiPcapSink(Ptr<AsyncPcapWriter> file,
              Ptr<const Packet> packet,
              uint16_t channelFreqMhz,
              WifiTxVector txVector,
@@ -1292,10 +1264,26 @@ WifiPcapSink(Ptr<PcapFileWrapper> file,
     file->Write(Simulator::Now(), packet);
 }
 
+Ptr<AsyncPcapWriter>
+CreatePcapWriter(const std::string& filename,
+                 uint32_t dataLinkType,
+                 const PcapCaptureOptions& options)
+{
+    Ptr<AsyncPcapWriter> file = Create<AsyncPcapWriter>(filename, dataLinkType, options);
+    // Simulator::Destroy() 时落盘
+    Simulator::ScheduleDestroy([file]() { file->Close(); });
+    return file;
+}
+
 void
-EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = false)
+EnablePcapAuto(const ConfigJsonHelper& helper,
+               const std::string& prefix,
+               uint32_t linkId,
+               const PcapCaptureOptions& options = PcapCaptureOptions(),
+               bool promiscuous = false)
 {
-    PcapHelper pcapHelper;
+    if (!helper.IsLinkInstalled(linkId))
+        return;
 
     Ptr<Channel> channel = Names::Find<Channel>("link" + std::to_string(linkId) + "-channel");
     NS_ASSERT_MSG(channel, "Channel not found: channel" << linkId);
@@ -1306,6 +1294,9 @@ EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = fa
         Ptr<NetDevice> dev = channel->GetDevice(i);
         Ptr<Node> node = dev->GetNode();
         uint32_t nodeId = node->GetId();
+        // 跨 rank 链路上远端的设备由所属 rank 抓包
+        if (helper.partition && node->GetSystemId() != helper.partition->GetRank())
+            continue;
 
         std::string filename =
             prefix + "-link" + std::to_string(linkId) + "-node" + std::to_string(nodeId) + ".pcap";
@@ -1313,8 +1304,7 @@ EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = fa
         // === CSMA ===
         if (dev->GetObject<CsmaNetDevice>())
         {
-            Ptr<PcapFileWrapper> file =
-                pcapHelper.CreateFile(filename, std::ios::out, PcapHelper::DLT_EN10MB);
+            Ptr<AsyncPcapWriter> file = CreatePcapWriter(filename, PcapHelper::DLT_EN10MB, options);
 
             std::string traceName = promiscuous ? "PromiscSniffer" : "Sniffer";
             dev->TraceConnectWithoutContext(traceName, MakeBoundCallback(&DefaultSink, file));
@@ -1324,8 +1314,7 @@ EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = fa
         // === P2P ===
         if (dev->GetObject<PointToPointNetDevice>())
         {
-            Ptr<PcapFileWrapper> file =
-                pcapHelper.CreateFile(filename, std::ios::out, PcapHelper::DLT_PPP);
+            Ptr<AsyncPcapWriter> file = CreatePcapWriter(filename, PcapHelper::DLT_PPP, options);
 
             dev->TraceConnectWithoutContext("PromiscSniffer",
                                             MakeBoundCallback(&DefaultSink, file));
@@ -1341,8 +1330,8 @@ EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = fa
 
         if (phy)
         {
-            Ptr<PcapFileWrapper> file =
-                pcapHelper.CreateFile(filename, std::ios::out, PcapHelper::DLT_IEEE802_11);
+            Ptr<AsyncPcapWriter> file =
+                CreatePcapWriter(filename, PcapHelper::DLT_IEEE802_11, options);
 
             phy->TraceConnectWithoutContext("MonitorSnifferRx",
                                             MakeBoundCallback(&WifiPcapSink, file));
@@ -1351,6 +1340,304 @@ EnablePcapAuto(const std::string& prefix, uint32_t linkId, bool promiscuous = fa
     }
 }
 
+uint8_t
+ParsePcapProtocol(const json& j)
+{
+    if (j.is_number_unsigned())
+        return j.get<uint8_t>();
+
+    const std::string s = j.get<std::string>();
+    if (s == "tcp")
+        return 6;
+    if (s == "udp")
+        return 17;
+    if (s == "icmp")
+        return 1;
+    if (s == "icmpv6")
+        return 58;
+    throw std::invalid_argument("Unknown pcap filter protocol: " + s);
+}
+
+// pcapLinkId 的元素可以是链路 id，也可以是带抓包选项的对象
+PcapCaptureOptions
+ParsePcapOptions(const json& j, const PcapCaptureOptions& defaults, uint32_t& linkId)
+{
+    PcapCaptureOptions options = defaults;
+    if (j.is_number())
+    {
+        linkId = j.get<uint32_t>();
+        return options;
+    }
+
+    linkId = j.at("linkId").get<uint32_t>();
+    options.snaplen = j.value("snaplen", options.snaplen);
+    options.maxFileSize = j.value("maxFileSize", options.maxFileSize);
+    options.maxFiles = j.value("maxFiles", options.maxFiles);
+    options.sampleEvery = j.value("sampleEvery", options.sampleEvery);
+    if (options.sampleEvery == 0)
+        throw std::invalid_argument("pcap sampleEvery must be >= 1");
+
+    if (j.contains("filter"))
+    {
+        const auto& f = j.at("filter");
+        if (f.contains("protocol"))
+            options.protocol = ParsePcapProtocol(f.at("protocol"));
+        if (f.contains("port"))
+            options.port = f.at("port").get<uint16_t>();
+    }
+    return options;
+}
+
+TypeId
+ParseSchedulerType(const std::string& s)
+{
+    static const std::unordered_map<std::string, std::string> table = {
+        {"map", "ns3::MapScheduler"},
+        {"heap", "ns3::HeapScheduler"},
+        {"list", "ns3::ListScheduler"},
+        {"calendar", "ns3::CalendarScheduler"},
+        {"priorityQueue", "ns3::PriorityQueueScheduler"},
+    };
+
+    auto it = table.find(s);
+    TypeId tid;
+    if (!TypeId::LookupByNameFailSafe(it == table.end() ? s : it->second, &tid) ||
+        !tid.IsChildOf(Scheduler::GetTypeId()))
+    {
+        throw std::invalid_argument("Unknown scheduler: " + s);
+    }
+    return tid;
+}
+
+// 切换事件调度器（已调度的事件会被搬移）；counting 时外包 CountingScheduler 供遥测读取
+void
+UseScheduler(TypeId tid, bool counting)
+{
+    GlobalValue::Bind("SchedulerType", TypeIdValue(tid));
+    if (counting)
+    {
+        SimulatorTelemetry::InstallCountingScheduler();
+        return;
+    }
+    ObjectFactory factory;
+    factory.SetTypeId(tid);
+    Simulator::SetScheduler(factory);
+}
+
+/**
+ * 先把仿真推进到第一个应用启动的时刻，之后每个候选调度器依次执行同样多（events 个）的事件，
+ * 按事件速率取最快者。应用启动前大多只有协议初始化事件，不代表正式运行的负载。
+ * 各调度器都按 (时间戳, uid) 出队，事件顺序与所选调度器无关，
+ * 预热段就是正式仿真的一部分，不影响结果。
+ *
+ * 预热最多推进到第一个应用启动与 stopTime 的中点。有候选没有执行满 events 个事件
+ * （到达该时刻或事件队列为空）时不作判断，返回 fallback。
+ */
+TypeId
+SelectSchedulerByWarmup(const std::vector<TypeId>& candidates,
+                        uint64_t events,
+                        TypeId fallback,
+                        Time stopTime)
+{
+    Time first = stopTime;
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        for (uint32_t i = 0; i < (*it)->GetNApplications(); ++i)
+        {
+            TimeValue start;
+            (*it)->GetApplication(i)->GetAttribute("StartTime", start);
+            first = std::min(first, start.Get());
+        }
+    }
+    const Time limit = first + (stopTime - first) / 2;
+    if (first >= stopTime || limit <= Simulator::Now())
+    {
+        NS_LOG_INFO("scheduler warm-up: no application traffic before stopTime");
+        return fallback;
+    }
+    if (first > Simulator::Now())
+    {
+        Simulator::Stop(first - Simulator::Now());
+        Simulator::Run();
+    }
+
+    // 候选都经 CountingScheduler 计数，额外开销对各候选相同
+    CountingScheduler::Counters& counters = CountingScheduler::GetCounters();
+    EventId guard = Simulator::Stop(limit - Simulator::Now());
+    TypeId best = fallback;
+    double bestRate = 0;
+    for (const auto& tid : candidates)
+    {
+        UseScheduler(tid, true);
+        const uint64_t begin = counters.executed.load(std::memory_order_relaxed);
+        counters.stopAt.store(begin + events, std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        Simulator::Run();
+        const double wall =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        counters.stopAt.store(UINT64_MAX, std::memory_order_relaxed);
+
+        const uint64_t executed = counters.executed.load(std::memory_order_relaxed) - begin;
+        if (executed < events)
+        {
+            NS_LOG_INFO("scheduler warm-up: " << tid.GetName() << " ran out after " << executed
+                                              << " events, keeping " << fallback.GetName());
+            best = fallback;
+            break;
+        }
+        const double rate = wall > 0 ? events / wall : 0;
+        NS_LOG_INFO("scheduler warm-up: " << tid.GetName() << " " << rate << " events/s");
+        if (rate > bestRate)
+        {
+            best = tid;
+            bestRate = rate;
+        }
+    }
+    guard.Cancel();
+    return best;
+}
+
+void
+ConfigureRng(const json& jSimulator)
+{
+    if (jSimulator.contains("seed"))
+        RngSeedManager::SetSeed(jSimulator.at("seed").get<uint32_t>());
+    if (jSimulator.contains("run"))
+        RngSeedManager::SetRun(jSimulator.at("run").get<uint64_t>());
+}
+
+void
+ConfigureSimulatorImplementation(const json& jSimulator, const ConfigJsonHelper& helper)
+{
+    const std::string impl = jSimulator.value("implementation", "default");
+    if (impl == "default")
+        return;
+    if (impl != "realtime")
+        throw std::invalid_argument("Unknown simulator implementation: " + impl);
+    if (helper.partition)
+        throw std::invalid_argument("realtime implementation cannot be used with MPI");
+
+    if (jSimulator.contains("realtime"))
+    {
+        const auto& jRealtime = jSimulator.at("realtime");
+        const std::string mode = jRealtime.value("mode", "bestEffort");
+        if (mode == "bestEffort")
+            Config::SetDefault("ns3::RealtimeSimulatorImpl::SynchronizationMode",
+                               StringValue("BestEffort"));
+        else if (mode == "hardLimit")
+            Config::SetDefault("ns3::RealtimeSimulatorImpl::SynchronizationMode",
+                               StringValue("HardLimit"));
+        else
+            throw std::invalid_argument("Unknown realtime.mode: " + mode);
+        if (jRealtime.contains("hardLimit"))
+            Config::SetDefault("ns3::RealtimeSimulatorImpl::HardLimit",
+                               TimeValue(Time(jRealtime.at("hardLimit").get<std::string>())));
+    }
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::RealtimeSimulatorImpl"));
+}
+
+// FlowMonitor（可选）：按给定时刻导出快照、周期采样
+void
+InstallFlowMonitor(const json& jSimulator,
+                   ConfigJsonHelper& helper,
+                   const std::string& simName,
+                   Time duration)
+{
+    if (!jSimulator.contains("flowMonitorTimes") && !jSimulator.contains("flowMonitorSampling"))
+        return;
+
+    auto flow = new (
+        FlowMonitorHelper); // 由于FlowMonitorHelper的析构会同时析构monitor和classifier，必须保障其生存期
+
+    Ptr<FlowMonitor> monitor = flow->InstallAll();
+
+    /* ---------- Snapshots at given times ---------- */
+    if (jSimulator.contains("flowMonitorTimes"))
+    {
+        const auto& val = jSimulator.at("flowMonitorTimes");
+        NS_ASSERT(val.is_array());
+
+        std::string format = "csv";
+        std::string file;
+        if (jSimulator.contains("flowMonitorOutput"))
+        {
+            const auto& jOutput = jSimulator.at("flowMonitorOutput");
+            for (auto it = jOutput.begin(); it != jOutput.end(); ++it)
+            {
+                if (it.key() == "format")
+                    format = it.value().get<std::string>();
+                else if (it.key() == "file")
+                    file = it.value().get<std::string>();
+            }
+        }
+        if (file.empty())
+        {
+            file = simName + "-flowmon." + (format == "binary" ? "bin" : format);
+        }
+        helper.mergeableOutputs.emplace_back(file, format);
+        file = helper.OutputPath(file);
+
+        auto exporter = std::make_shared<FlowMonitorExporter>(flow,
+                                                              monitor,
+                                                              file,
+                                                              ParseFlowExportFormat(format));
+
+        for (const auto& t : val)
+        {
+            Time printTime = Time(t.get<std::string>());
+            if (printTime == duration)
+            {
+                printTime -= NanoSeconds(100);
+            }
+            Simulator::Schedule(printTime, [exporter]() { exporter->Snapshot(); });
+        }
+        // Simulator::Destroy() 时落盘
+        Simulator::ScheduleDestroy([exporter]() { exporter->Close(); });
+    }
+
+    /* ---------- Periodic sampling ---------- */
+    if (jSimulator.contains("flowMonitorSampling"))
+    {
+        const auto& jSampling = jSimulator.at("flowMonitorSampling");
+
+        Time interval = Time(jSampling.at("interval").get<std::string>());
+        uint32_t capacity = 1024;
+        auto onFull = FlowMonitorSampler::OnFull::Downsample;
+        std::string file = simName + "-flowmon-series.csv";
+
+        for (auto it = jSampling.begin(); it != jSampling.end(); ++it)
+        {
+            const std::string& key = it.key();
+            const auto& v = it.value();
+
+            if (key == "capacity")
+                capacity = v.get<uint32_t>();
+            else if (key == "file")
+                file = v.get<std::string>();
+            else if (key == "onFull")
+            {
+                const std::string mode = v.get<std::string>();
+                if (mode == "downsample")
+                    onFull = FlowMonitorSampler::OnFull::Downsample;
+                else if (mode == "spill")
+                    onFull = FlowMonitorSampler::OnFull::Spill;
+                else
+                    throw std::invalid_argument("Unknown flowMonitorSampling.onFull: " + mode);
+            }
+        }
+
+        helper.mergeableOutputs.emplace_back(file, "csv");
+        auto sampler = std::make_shared<FlowMonitorSampler>(flow,
+                                                            monitor,
+                                                            helper.OutputPath(file),
+                                                            interval,
+                                                            capacity,
+                                                            onFull);
+        sampler->Start();
+        Simulator::ScheduleDestroy([sampler]() { sampler->Close(); });
+    }
+}
+
 void
 SimulatorHandler(const json& jSimulator, ConfigJsonHelper& helper)
 {
@@ -1359,23 +1646,20 @@ SimulatorHandler(const json& jSimulator, ConfigJsonHelper& helper)
 
     Simulator::Stop(duration);
 
+    PcapCaptureOptions pcapDefaults;
+    if (jSimulator.contains("snaplen"))
+    {
+        pcapDefaults.snaplen = jSimulator.at("snaplen").get<uint32_t>();
+    }
+
     for (auto it = jSimulator.begin(); it != jSimulator.end(); ++it)
     {
         const std::string& key = it.key();
         const auto& val = it.value();
 
-        // ===== RNG =====
-        if (key == "seed")
-        {
-            RngSeedManager::SetSeed(val.get<uint32_t>());
-        }
-        else if (key == "run")
-        {
-            RngSeedManager::SetRun(val.get<uint64_t>());
-        }
-
         // ===== LOG =====
-        else if (key == "log")
+        // seed / run 在 Install 开始时由 ConfigureRng 设置
+        if (key == "log")
         {
             NS_ASSERT(val.is_array());
             for (const auto& item : val)
@@ -1390,57 +1674,144 @@ SimulatorHandler(const json& jSimulator, ConfigJsonHelper& helper)
         else if (key == "pcapLinkId")
         {
             NS_ASSERT(val.is_array());
-            for (const auto& linkId : val)
+            for (const auto& item : val)
             {
-                EnablePcapAuto(simName, linkId.get<uint32_t>());
+                uint32_t linkId = 0;
+                PcapCaptureOptions options = ParsePcapOptions(item, pcapDefaults, linkId);
+                // 分布式时输出文件名附加 -rank<r>
+                EnablePcapAuto(helper, helper.OutputPath(simName), linkId, options);
             }
         }
+    }
 
-        // ===== FLOW MONITOR =====
-        else if (key == "flowMonitorTimes")
+    /* ===============================
+     * Event scheduler (optional)
+     * =============================== */
+    std::vector<TypeId> schedulerCandidates;
+    uint64_t schedulerWarmupEvents = 100000;
+    if (jSimulator.contains("scheduler"))
+    {
+        const auto& jScheduler = jSimulator.at("scheduler");
+        const std::string type = jScheduler.is_string() ? jScheduler.get<std::string>()
+                                                        : jScheduler.at("type").get<std::string>();
+        if (type != "auto")
         {
-            NS_ASSERT(val.is_array());
+            UseScheduler(ParseSchedulerType(type), false);
+        }
+        else
+        {
+            if (jSimulator.value("implementation", "default") == "realtime")
+                throw std::invalid_argument("scheduler auto cannot be used with realtime");
+            if (helper.partition)
+                throw std::invalid_argument("scheduler auto cannot be used with MPI");
+
+            // list 的插入为 O(n)，大事件队列下预热本身就可能很慢，默认不参与
+            std::vector<std::string> names = {"map", "heap", "calendar", "priorityQueue"};
+            if (jScheduler.is_object())
+            {
+                if (jScheduler.contains("candidates"))
+                    names = jScheduler.at("candidates").get<std::vector<std::string>>();
+                if (jScheduler.contains("warmupEvents"))
+                    schedulerWarmupEvents = jScheduler.at("warmupEvents").get<uint64_t>();
+            }
+            if (schedulerWarmupEvents == 0)
+                throw std::invalid_argument("scheduler.warmupEvents must be > 0");
+            for (const auto& name : names)
+                schedulerCandidates.push_back(ParseSchedulerType(name));
+            if (schedulerCandidates.empty())
+                throw std::invalid_argument("scheduler.candidates is empty");
+        }
+    }
+
+    /* ===============================
+     * Telemetry (optional)
+     * =============================== */
+    if (jSimulator.contains("telemetry"))
+    {
+        const auto& jTelemetry = jSimulator.at("telemetry");
+        // interval 为墙钟间隔，用 ns-3 的时间字符串书写
+        const Time interval = Time(jTelemetry.value("interval", "1s"));
+        const std::string file =
+            helper.OutputPath(jTelemetry.value("file", simName + "-telemetry.csv"));
+        if (interval.GetMilliSeconds() <= 0)
+            throw std::invalid_argument("telemetry.interval must be >= 1ms");
+
+        SimulatorTelemetry::InstallCountingScheduler();
+        auto telemetry = std::make_shared<SimulatorTelemetry>(
+            file,
+            std::chrono::milliseconds(interval.GetMilliSeconds()),
+            duration);
+        // 安装耗时不计入，仿真开始后才启动采样线程
+        Simulator::ScheduleNow([telemetry]() { telemetry->Start(); });
+        Simulator::ScheduleDestroy([telemetry]() { telemetry->Stop(); });
+    }
 
-            auto flow = new (
-                FlowMonitorHelper); // 由于FlowMonitorHelper的析构会同时析构monitor和classifier，必须保障其生存期
+    /* ===============================
+     * Prometheus metrics (optional)
+     * =============================== */
+    if (jSimulator.contains("metrics"))
+    {
+        const auto& jMetrics = jSimulator.at("metrics");
+        // interval 为仿真时间间隔
+        const Time interval = Time(jMetrics.value("interval", "1s"));
+        if (!interval.IsStrictlyPositive())
+            throw std::invalid_argument("metrics.interval must be > 0");
+        std::string file;
+        if (jMetrics.contains("file"))
+            file = helper.OutputPath(jMetrics.at("file").get<std::string>());
+        uint32_t port = jMetrics.value("port", 0u);
+        // 分布式时每个 rank 监听 port + rank
+        if (port != 0 && helper.partition)
+            port += helper.partition->GetRank();
+        if (port > 65535)
+            throw std::invalid_argument("metrics.port out of range");
+        if (file.empty() && port == 0)
+            throw std::invalid_argument("metrics needs file or port");
+
+        auto metrics = std::make_shared<MetricsExporter>(file, port, interval);
+        if (jMetrics.value("applications", true))
+            metrics->AttachApplications();
+        if (jMetrics.value("devices", true))
+            metrics->AttachDevices();
+        Simulator::ScheduleNow([metrics]() { metrics->Start(); });
+        Simulator::ScheduleDestroy([metrics]() { metrics->Stop(); });
+    }
 
-            Ptr<FlowMonitor> monitor = flow->InstallAll();
+    /* ===============================
+     * Application counters (optional)
+     * =============================== */
+    // 由 applications.json 中各应用的 "counters" 登记，这里只决定输出文件
+    if (helper.appCounters)
+    {
+        const std::string file =
+            jSimulator.value("appCountersFile", simName + "-app-counters.csv");
+        helper.mergeableOutputs.emplace_back(file, "csv");
+        auto counters = helper.appCounters;
+        counters->Start(helper.OutputPath(file));
+        Simulator::ScheduleDestroy([counters]() { counters->Close(); });
+        NS_LOG_INFO("app counters: " << counters->GetNApplications() << " applications");
+    }
 
-            Ptr<FlowClassifier> classifier = flow->GetClassifier();
+    InstallFlowMonitor(jSimulator, helper, simName, duration);
 
-            for (const auto& t : val)
-            {
-                Time printTime = Time(t.get<std::string>());
-                if (printTime == duration)
-                {
-                    printTime -= NanoSeconds(100);
-                }
-                Simulator::Schedule(printTime, [flow, monitor, printTime]() {
-                    if (!monitor)
-                        return;
-
-                    monitor->CheckForLostPackets();
-
-                    Ptr<Ipv4FlowClassifier> classifier =
-                        DynamicCast<Ipv4FlowClassifier>(flow->GetClassifier());
-                    if (!classifier)
-                        return;
-
-                    const auto& stats = monitor->GetFlowStats();
-                    std::cout << "=== FlowMonitor @" << printTime.GetSeconds() << "s ===\n";
-                    std::cout << "检测到的流量数量: " << stats.size() << std::endl;
-
-                    for (const auto& [flowId, stat] : stats)
-                    {
-                        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
-                        std::cout << "Flow " << flowId << ": " << t.sourceAddress << ":"
-                                  << t.sourcePort << " -> " << t.destinationAddress << ":"
-                                  << t.destinationPort << " Tx: " << stat.txPackets
-                                  << " Rx: " << stat.rxPackets << std::endl;
-                    }
-                });
-            }
-        }
+    /* ===============================
+     * Scheduler auto selection
+     * =============================== */
+    // 预热会推进仿真，这里只登记，由 ConfigJsonHelper::WarmUpScheduler() 在 Install 之后执行
+    if (!schedulerCandidates.empty())
+    {
+        const bool counting = jSimulator.contains("telemetry");
+        TypeIdValue fallback;
+        GlobalValue::GetValueByName("SchedulerType", fallback);
+        helper.schedulerWarmup = [candidates = std::move(schedulerCandidates),
+                                  events = schedulerWarmupEvents,
+                                  fallback = fallback.Get(),
+                                  duration,
+                                  counting]() {
+            TypeId best = SelectSchedulerByWarmup(candidates, events, fallback, duration);
+            UseScheduler(best, counting);
+            NS_LOG_INFO("scheduler: " << best.GetName());
+        };
     }
 }
 }
@@ -7,6 +7,12 @@
 #define CONFIG_JSON_HANDLER_DEFAULT_H
 
 #include "../helper/config-json2-helper.h"
+#include "config-json2-flow-monitor.h"
+#include "config-json2-metrics.h"
+#include "config-json2-pcap.h"
+#include "config-json2-profile.h"
+#include "config-json2-telemetry.h"
+#include "config-json2-timeline.h"
 
 #include "ns3/applications-module.h"
 #include "ns3/bridge-module.h"
@@ -14,6 +20,7 @@
 #include "ns3/flow-monitor-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/mobility-module.h"
+#include "ns3/nix-vector-routing-module.h"
 #include "ns3/olsr-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/spectrum-module.h"
@@ -21,12 +28,12 @@
 
 #include <fstream>
 #include <iostream>
+#include <optional>
 
 namespace ns3
 {
 namespace configjson2
 {
-using json = nlohmann::json;
 // Config
 void ConfigHandler(const json& jConfig, ConfigJsonHelper& helper);
 
@@ -49,19 +56,88 @@ void Ipv6NetworkHandler(const json& jNetwork, ConfigJsonHelper& helper);
 void Ipv4StaticHandler(const json& jRouting, ConfigJsonHelper& helper);
 void Ipv6StaticHandler(const json& jRouting, ConfigJsonHelper& helper);
 void OlsrHandler(const json& jRoutingProtocol, ConfigJsonHelper& helper);
+// 所有节点都用 nix 时可改用 internet-stack.json 的 enableNixRouting
+void Ipv4NixHandler(const json& jRouting, ConfigJsonHelper& helper);
+void Ipv6NixHandler(const json& jRouting, ConfigJsonHelper& helper);
 
-// Mobility
+// Mobility：两段式，Decode* 线程安全，Apply* 创建 ns-3 对象；*Handler 为二者的组合
+struct MobilityConfig
+{
+    uint32_t nodeId = 0;
+    Vector position;
+    std::vector<Waypoint> waypoints;
+};
+
+MobilityConfig DecodeMobility(const json& jMobility);
+void ApplyConstantPositionMobility(const MobilityConfig& config, ConfigJsonHelper& helper);
+void ApplyWaypointMobility(const MobilityConfig& config, ConfigJsonHelper& helper);
 void ConstantPositionMobilityHandler(const json& jMobility, ConfigJsonHelper& helper);
 void WaypointMobilityHandler(const json& jMobility, ConfigJsonHelper& helper);
 
-// Application
+// Application：两段式，各类型共用 DecodeApplication
+struct AppSocketConfig
+{
+    bool ipv6 = false;
+    uint16_t port = 0;
+    uint32_t remoteNodeId = 0;
+    bool hasLinkId = false;
+    uint32_t linkId = 0;
+};
+
+struct ApplicationConfig
+{
+    uint32_t nodeId = 0;
+    uint32_t applicationId = 0;
+    Time start;
+    Time stop;
+    AppSocketConfig socket;
+    uint32_t maxPackets = 0; // UdpEchoClient
+    Time interval;           // UdpEchoClient
+    uint32_t packetSize = 0; // UdpEchoClient / OnOff
+    DataRate dataRate;       // OnOff
+    std::string protocol;    // PacketSink
+    std::string profile;     // OnOff，见 ProfileSet
+    Time counters;           // 吞吐计数的采样间隔，0 表示不计数，见 ApplicationCounterSampler
+};
+
+ApplicationConfig DecodeApplication(const json& jApplication);
+void ApplyUdpEchoClient(const ApplicationConfig& config, ConfigJsonHelper& helper);
+void ApplyUdpEchoServer(const ApplicationConfig& config, ConfigJsonHelper& helper);
+void ApplyOnOff(const ApplicationConfig& config, ConfigJsonHelper& helper);
+void ApplyPacketSink(const ApplicationConfig& config, ConfigJsonHelper& helper);
 void UdpEchoClientHandler(const json& jApplication, ConfigJsonHelper& helper);
 void UdpEchoServerHandler(const json& jApplication, ConfigJsonHelper& helper);
 void OnOffHandler(const json& jApplication, ConfigJsonHelper& helper);
 void PacketSinkHandler(const json& jApplication, ConfigJsonHelper& helper);
 
+// Timeline：两段式，整个 timeline.json 为一项；Decode 解析时间和值，Apply 解析目标对象并调度
+struct TimelineChange
+{
+    Time time;
+    std::string path;        // configPath 时为 Config 路径（不含属性名），否则为 Names 路径
+    bool configPath = false;
+    std::optional<uint32_t> nodeId; // target 形式，用于判断是否在本进程安装
+    std::optional<uint32_t> linkId;
+    std::string attribute;
+    std::string value;
+};
+
+struct TimelineConfig
+{
+    std::vector<TimelineChange> changes;
+};
+
+TimelineConfig DecodeTimeline(const json& jTimeline);
+void ApplyTimeline(const TimelineConfig& config, ConfigJsonHelper& helper);
+void TimelineHandler(const json& jTimeline, ConfigJsonHelper& helper);
+
 // Simulator
 void SimulatorHandler(const json& jSimulator, ConfigJsonHelper& helper);
+// 按 simulator.json 的 seed / run 设置随机数种子。RandomVariableStream 在构造时读取种子，
+// 须在安装阶段创建任何随机变量之前调用
+void ConfigureRng(const json& jSimulator);
+// 按 simulator.json 的 implementation 绑定仿真器实现，须在第一次使用 Simulator 之前调用
+void ConfigureSimulatorImplementation(const json& jSimulator, const ConfigJsonHelper& helper);
 } // namespace configjson2
 } // namespace ns3
 
@@ -4,8 +4,6 @@ namespace ns3
 {
 namespace configjson2
 {
-using json = nlohmann::json;
-
 void
 GazeboMobilityHandler(const json& jMobility, ConfigJsonHelper& helper)
 {
@@ -0,0 +1,553 @@
+#include "config-json2-metrics.h"
+
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Metrics");
+
+namespace
+{
+void
+CountTx(PacketCounter* counter, Ptr<const Packet> packet)
+{
+    counter->bytes += packet->GetSize();
+    ++counter->packets;
+}
+
+void
+CountRx(PacketCounter* counter, Ptr<const Packet> packet, const Address&)
+{
+    counter->bytes += packet->GetSize();
+    ++counter->packets;
+}
+
+void
+CountQueueDrop(uint64_t* drops, Ptr<const Packet>)
+{
+    ++*drops;
+}
+
+void
+CountQueueDiscDrop(uint64_t* drops, Ptr<const QueueDiscItem>)
+{
+    ++*drops;
+}
+
+void
+CountIpv4Drop(uint64_t* drops,
+              const Ipv4Header&,
+              Ptr<const Packet>,
+              Ipv4L3Protocol::DropReason,
+              Ptr<Ipv4>,
+              uint32_t)
+{
+    ++*drops;
+}
+
+// 一个指标的 HELP / TYPE 头
+void
+AppendHeader(std::string& out, const char* name, const char* type, const char* help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void
+AppendSample(std::string& out,
+             const char* name,
+             const char* label,
+             const std::string& value,
+             uint64_t sample)
+{
+    out += name;
+    out += '{';
+    out += label;
+    out += "=\"";
+    out += value;
+    out += "\"} ";
+    out += std::to_string(sample);
+    out += '\n';
+}
+
+// 设备的发送队列，只支持 p2p 和 csma
+Ptr<Queue<Packet>>
+DeviceQueue(Ptr<NetDevice> dev)
+{
+    if (auto p2p = DynamicCast<PointToPointNetDevice>(dev))
+        return p2p->GetQueue();
+    if (auto csma = DynamicCast<CsmaNetDevice>(dev))
+        return csma->GetQueue();
+    return nullptr;
+}
+} // namespace
+
+bool
+ConnectApplicationCounters(Ptr<Application> app, PacketCounter* rx, PacketCounter* tx)
+{
+    if (DynamicCast<PacketSink>(app))
+        return app->TraceConnectWithoutContext("Rx", MakeBoundCallback(&CountRx, rx));
+    if (DynamicCast<OnOffApplication>(app) || DynamicCast<UdpEchoClient>(app))
+        return app->TraceConnectWithoutContext("Tx", MakeBoundCallback(&CountTx, tx));
+    return false;
+}
+
+bool
+ApplicationCounterSampler::Add(const std::string& name,
+                               Ptr<Application> app,
+                               Time interval,
+                               Time start,
+                               Time stop)
+{
+    m_entries.push_back({name, interval, stop, {}, {}, {}, {}, start});
+    Entry& entry = m_entries.back();
+    if (!ConnectApplicationCounters(app, &entry.rx, &entry.tx))
+    {
+        m_entries.pop_back();
+        return false;
+    }
+    return true;
+}
+
+void
+ApplicationCounterSampler::Start(const std::string& path)
+{
+    m_run = RngSeedManager::GetRun();
+    m_writer = std::make_unique<AsyncFileWriter>(path);
+    m_writer->Write(std::string("run,app,timeNs,intervalNs,txBytes,txPackets,rxBytes,rxPackets,"
+                                "throughputBps\n"));
+    for (Entry& entry : m_entries)
+    {
+        Time first = entry.last + entry.interval;
+        if (entry.stop.IsStrictlyPositive())
+            first = std::min(first, entry.stop);
+        Simulator::Schedule(std::max(first - Simulator::Now(), Time(0)),
+                            &ApplicationCounterSampler::Sample,
+                            this,
+                            &entry);
+    }
+}
+
+void
+ApplicationCounterSampler::Close()
+{
+    if (m_writer)
+        m_writer->Close();
+}
+
+std::size_t
+ApplicationCounterSampler::GetNApplications() const
+{
+    return m_entries.size();
+}
+
+void
+ApplicationCounterSampler::Sample(Entry* entry)
+{
+    const Time now = Simulator::Now();
+    const int64_t intervalNs = (now - entry->last).GetNanoSeconds();
+    const uint64_t txBytes = entry->tx.bytes - entry->lastTx.bytes;
+    const uint64_t rxBytes = entry->rx.bytes - entry->lastRx.bytes;
+
+    m_line.clear();
+    m_line += std::to_string(m_run);
+    m_line += ',';
+    m_line += entry->name;
+    for (const uint64_t v : {static_cast<uint64_t>(now.GetNanoSeconds()),
+                             static_cast<uint64_t>(intervalNs),
+                             txBytes,
+                             entry->tx.packets - entry->lastTx.packets,
+                             rxBytes,
+                             entry->rx.packets - entry->lastRx.packets})
+    {
+        m_line += ',';
+        m_line += std::to_string(v);
+    }
+    // 一个应用只有一个方向在计数
+    char rate[32];
+    std::snprintf(rate,
+                  sizeof(rate),
+                  ",%.0f\n",
+                  intervalNs > 0 ? (txBytes + rxBytes) * 8e9 / intervalNs : 0.0);
+    m_line += rate;
+    m_writer->Write(m_line);
+
+    entry->lastTx = entry->tx;
+    entry->lastRx = entry->rx;
+    entry->last = now;
+
+    // 最后一个区间截止到应用停止时刻
+    if (entry->stop.IsStrictlyPositive() && now >= entry->stop)
+        return;
+    Time next = entry->interval;
+    if (entry->stop.IsStrictlyPositive())
+        next = std::min(next, entry->stop - now);
+    Simulator::Schedule(next, &ApplicationCounterSampler::Sample, this, entry);
+}
+
+MetricsExporter::MetricsExporter(const std::string& path, uint16_t port, Time interval)
+    : m_path(path),
+      m_port(port),
+      m_interval(interval)
+{
+    if (m_port == 0)
+        return;
+
+    // 只绑定回环地址，不对外暴露
+    m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+        throw std::runtime_error(std::string("metrics: socket: ") + std::strerror(errno));
+    int one = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(m_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(m_listenFd, 16) < 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error("metrics: cannot listen on 127.0.0.1:" + std::to_string(m_port) +
+                                 ": " + error);
+    }
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    Stop();
+}
+
+void
+MetricsExporter::AttachApplications()
+{
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<Node> node = *it;
+        for (uint32_t i = 0; i < node->GetNApplications(); ++i)
+        {
+            Ptr<Application> app = node->GetApplication(i);
+            // 只统计由 applications.json 安装（有名字）的应用
+            const std::string name = Names::FindName(app);
+            if (name.empty())
+                continue;
+            m_apps.push_back({name, {}, {}});
+            if (!ConnectApplicationCounters(app, &m_apps.back().rx, &m_apps.back().tx))
+                m_apps.pop_back();
+        }
+    }
+}
+
+void
+MetricsExporter::AttachDevices()
+{
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<Node> node = *it;
+        Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+        for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> dev = node->GetDevice(i);
+            const std::string name = Names::FindName(dev);
+            if (name.empty())
+                continue;
+
+            DeviceCounters counters;
+            counters.name = name;
+            counters.queue = DeviceQueue(dev);
+            counters.qdisc = tc ? tc->GetRootQueueDiscOnDevice(dev) : nullptr;
+            if (!counters.queue && !counters.qdisc)
+                continue;
+            m_devices.push_back(std::move(counters));
+            DeviceCounters& c = m_devices.back();
+            if (c.queue)
+                c.queue->TraceConnectWithoutContext("Drop",
+                                                    MakeBoundCallback(&CountQueueDrop,
+                                                                      &c.queueDrops));
+            if (c.qdisc)
+                c.qdisc->TraceConnectWithoutContext("Drop",
+                                                    MakeBoundCallback(&CountQueueDiscDrop,
+                                                                      &c.qdiscDrops));
+        }
+
+        if (Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>())
+        {
+            m_nodes.push_back({node->GetId()});
+            ipv4->TraceConnectWithoutContext(
+                "Drop",
+                MakeBoundCallback(&CountIpv4Drop, &m_nodes.back().ipv4Drops));
+        }
+    }
+}
+
+void
+MetricsExporter::Start()
+{
+    if (m_thread.joinable())
+        return;
+    m_thread = std::thread(&MetricsExporter::Serve, this);
+    m_event = Simulator::ScheduleNow(&MetricsExporter::Collect, this);
+}
+
+void
+MetricsExporter::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_event.Cancel();
+    // 最后一次采集的结果先落盘再退出
+    std::string text = Format();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latest.swap(text);
+        m_dirty = true;
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+
+    if (m_listenFd >= 0)
+    {
+        close(m_listenFd);
+        m_listenFd = -1;
+    }
+}
+
+void
+MetricsExporter::Collect()
+{
+    std::string text = Format();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latest.swap(text);
+        m_dirty = true;
+    }
+    m_cv.notify_one();
+
+    m_event = Simulator::Schedule(m_interval, &MetricsExporter::Collect, this);
+}
+
+std::string
+MetricsExporter::Format() const
+{
+    std::string out;
+
+    AppendHeader(out, "configjson2_sim_time_seconds", "gauge", "Current simulation time.");
+    char now[64];
+    std::snprintf(now, sizeof(now), "%.9f\n", Simulator::Now().GetSeconds());
+    out += "configjson2_sim_time_seconds ";
+    out += now;
+
+    if (!m_apps.empty())
+    {
+        const std::pair<const char*, const char*> appMetrics[] = {
+            {"configjson2_app_rx_bytes_total", "Bytes received by the application."},
+            {"configjson2_app_rx_packets_total", "Packets received by the application."},
+            {"configjson2_app_tx_bytes_total", "Bytes sent by the application."},
+            {"configjson2_app_tx_packets_total", "Packets sent by the application."},
+        };
+        for (std::size_t m = 0; m < 4; ++m)
+        {
+            AppendHeader(out, appMetrics[m].first, "counter", appMetrics[m].second);
+            for (const auto& app : m_apps)
+            {
+                const PacketCounter& c = m < 2 ? app.rx : app.tx;
+                AppendSample(out,
+                             appMetrics[m].first,
+                             "app",
+                             app.name,
+                             m % 2 == 0 ? c.bytes : c.packets);
+            }
+        }
+    }
+
+    if (!m_devices.empty())
+    {
+        AppendHeader(out, "configjson2_queue_packets", "gauge", "Packets in the device queue.");
+        for (const auto& d : m_devices)
+        {
+            if (d.queue)
+                AppendSample(out,
+                             "configjson2_queue_packets",
+                             "device",
+                             d.name,
+                             d.queue->GetNPackets());
+        }
+        AppendHeader(out, "configjson2_queue_bytes", "gauge", "Bytes in the device queue.");
+        for (const auto& d : m_devices)
+        {
+            if (d.queue)
+                AppendSample(out,
+                             "configjson2_queue_bytes",
+                             "device",
+                             d.name,
+                             d.queue->GetNBytes());
+        }
+        AppendHeader(out,
+                     "configjson2_queue_drops_total",
+                     "counter",
+                     "Packets dropped by the device queue.");
+        for (const auto& d : m_devices)
+        {
+            if (d.queue)
+                AppendSample(out, "configjson2_queue_drops_total", "device", d.name, d.queueDrops);
+        }
+        AppendHeader(out, "configjson2_qdisc_packets", "gauge", "Packets in the root queue disc.");
+        for (const auto& d : m_devices)
+        {
+            if (d.qdisc)
+                AppendSample(out,
+                             "configjson2_qdisc_packets",
+                             "device",
+                             d.name,
+                             d.qdisc->GetNPackets());
+        }
+        AppendHeader(out,
+                     "configjson2_qdisc_drops_total",
+                     "counter",
+                     "Packets dropped by the root queue disc.");
+        for (const auto& d : m_devices)
+        {
+            if (d.qdisc)
+                AppendSample(out, "configjson2_qdisc_drops_total", "device", d.name, d.qdiscDrops);
+        }
+    }
+
+    if (!m_nodes.empty())
+    {
+        AppendHeader(out,
+                     "configjson2_ipv4_drops_total",
+                     "counter",
+                     "Packets dropped by the IPv4 layer.");
+        for (const auto& n : m_nodes)
+            AppendSample(out,
+                         "configjson2_ipv4_drops_total",
+                         "node",
+                         std::to_string(n.nodeId),
+                         n.ipv4Drops);
+    }
+    return out;
+}
+
+void
+MetricsExporter::Serve()
+{
+    while (true)
+    {
+        std::string text;
+        bool write = false;
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 不监听时没有别的事可做，等下一次采集
+            if (m_listenFd < 0)
+                m_cv.wait(lock, [this]() { return m_stop || m_dirty; });
+            if (m_dirty && !m_path.empty())
+            {
+                text = m_latest;
+                write = true;
+            }
+            m_dirty = false;
+            stop = m_stop;
+        }
+        if (write)
+            WriteFile(text);
+        if (stop)
+            break;
+
+        if (m_listenFd >= 0)
+        {
+            pollfd pfd{m_listenFd, POLLIN, 0};
+            if (poll(&pfd, 1, 200) <= 0 || !(pfd.revents & POLLIN))
+                continue;
+            const int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+                continue;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                text = m_latest;
+            }
+            Respond(fd, text);
+            close(fd);
+        }
+    }
+}
+
+void
+MetricsExporter::WriteFile(const std::string& text) const
+{
+    const std::string tmp = m_path + ".tmp";
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f)
+    {
+        NS_LOG_WARN("metrics: cannot open " << tmp);
+        return;
+    }
+    const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), m_path.c_str()) != 0)
+        NS_LOG_WARN("metrics: cannot write " << m_path);
+}
+
+void
+MetricsExporter::Respond(int fd, const std::string& text) const
+{
+    // 慢客户端最多占用后台线程 1 秒
+    timeval timeout{1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // 读完请求头即可，任何路径都返回全部指标
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192)
+    {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+            break;
+        request.append(buf, n);
+    }
+
+    const std::string header = "HTTP/1.1 200 OK\r\n"
+                               "Content-Type: text/plain; version=0.0.4\r\n"
+                               "Content-Length: " +
+                               std::to_string(text.size()) +
+                               "\r\n"
+                               "Connection: close\r\n\r\n";
+    for (const std::string* part : {&header, &text})
+    {
+        std::size_t sent = 0;
+        while (sent < part->size())
+        {
+            const ssize_t n = send(fd, part->data() + sent, part->size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                return;
+            sent += n;
+        }
+    }
+}
+} // namespace configjson2
+} // namespace ns3
@@ -0,0 +1,166 @@
+/**
+ * @file config-json2-metrics.h
+ * @brief In-simulation counters: per-application throughput CSV and Prometheus text export.
+ */
+
+#ifndef CONFIG_JSON_METRICS_H
+#define CONFIG_JSON_METRICS_H
+
+#include "config-json2-async-writer.h"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ns3
+{
+namespace configjson2
+{
+// trace sink 只累加的计数器
+struct PacketCounter
+{
+    uint64_t bytes = 0;
+    uint64_t packets = 0;
+};
+
+/**
+ * 把应用的收发 trace 接到计数器：PacketSink 的 Rx 计入 rx，OnOff / UdpEchoClient 的 Tx 计入 tx。
+ * 其他类型的应用不连接，返回 false。
+ */
+bool ConnectApplicationCounters(Ptr<Application> app, PacketCounter* rx, PacketCounter* tx);
+
+/**
+ * applications.json 中写了 "counters" 的应用的吞吐计数。
+ *
+ * 只在 PacketSink 的 Rx 或 OnOff / UdpEchoClient 的 Tx 上接一个累加字节数和包数的 sink，
+ * 每个应用按自己的间隔从启动时刻起采样到停止时刻，每个样本写一行 CSV（区间内的增量）：
+ *   run,app,timeNs,intervalNs,txBytes,txPackets,rxBytes,rxPackets,throughputBps
+ * 不需要 pcap 或 FlowMonitor 在每个节点、每个包上的开销。
+ */
+class ApplicationCounterSampler
+{
+  public:
+    // 应用须已设置启停时间；类型不支持时返回 false
+    bool Add(const std::string& name, Ptr<Application> app, Time interval, Time start, Time stop);
+    // 打开输出文件并调度各应用的第一次采样
+    void Start(const std::string& path);
+    void Close();
+    std::size_t GetNApplications() const;
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        Time interval;
+        Time stop; // 0 表示不停止
+        PacketCounter rx;
+        PacketCounter tx;
+        PacketCounter lastRx;
+        PacketCounter lastTx;
+        Time last; // 上一次采样时刻
+    };
+
+    void Sample(Entry* entry);
+
+    // deque：sink 持有元素地址，追加时不能搬移
+    std::deque<Entry> m_entries;
+    std::unique_ptr<AsyncFileWriter> m_writer;
+    std::string m_line;
+    uint64_t m_run = 0;
+};
+
+/**
+ * Prometheus 文本格式的指标导出。
+ *
+ * 安装时给应用和设备队列的 trace 接上只做加法的 sink，每隔 interval（仿真时间）在仿真线程上
+ * 读取计数器和队列长度并格式化为文本；写文件（先写 .tmp 再 rename，读者不会看到半个文件）
+ * 和回环地址上的 HTTP 响应都由后台线程完成，仿真线程不做 I/O。
+ *
+ * 指标：
+ *   configjson2_sim_time_seconds
+ *   configjson2_app_{rx,tx}_{bytes,packets}_total{app="node<n>-app<a>"}
+ *   configjson2_queue_{packets,bytes}{device="node<n>-link<l>"}     设备发送队列当前占用
+ *   configjson2_queue_drops_total{device}                           设备发送队列丢包
+ *   configjson2_qdisc_{packets,drops_total}{device}                 根 QueueDisc 占用 / 丢包
+ *   configjson2_ipv4_drops_total{node="<n>"}                        IPv4 层丢包（无路由、TTL 等）
+ */
+class MetricsExporter
+{
+  public:
+    // path 为空时不写文件，port 为 0 时不监听
+    MetricsExporter(const std::string& path, uint16_t port, Time interval);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // 连接已安装对象的 trace，须在安装完成后、仿真开始前调用
+    void AttachApplications();
+    void AttachDevices();
+
+    // 启动后台线程并调度第一次采集
+    void Start();
+    // 采集最后一次并停止后台线程，文件保留仿真结束时的值
+    void Stop();
+
+  private:
+    struct AppCounters
+    {
+        std::string name;
+        PacketCounter rx;
+        PacketCounter tx;
+    };
+
+    struct DeviceCounters
+    {
+        std::string name;
+        Ptr<Queue<Packet>> queue;
+        Ptr<QueueDisc> qdisc;
+        uint64_t queueDrops = 0;
+        uint64_t qdiscDrops = 0;
+    };
+
+    struct NodeCounters
+    {
+        uint32_t nodeId;
+        uint64_t ipv4Drops = 0;
+    };
+
+    void Collect();
+    std::string Format() const;
+    void Serve();
+    void WriteFile(const std::string& text) const;
+    void Respond(int fd, const std::string& text) const;
+
+    std::string m_path;
+    uint16_t m_port;
+    Time m_interval;
+    EventId m_event;
+    int m_listenFd = -1;
+
+    // deque：sink 持有元素地址，追加时不能搬移
+    std::deque<AppCounters> m_apps;
+    std::deque<DeviceCounters> m_devices;
+    std::deque<NodeCounters> m_nodes;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_latest;
+    bool m_dirty = false;
+    bool m_stop = false;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_METRICS_H
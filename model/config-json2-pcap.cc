@@ -0,0 +1,222 @@
+#include "config-json2-pcap.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+namespace configjson2
+{
+namespace
+{
+// 每个抓包文件的缓冲区，文件数量可能很多，不宜过大
+constexpr std::size_t kPcapBufferSize = 256u << 10;
+// 过滤时最多窥探的头部字节数：802.11 MAC(36) + A-MSDU(14) + LLC(8) + IPv6(40) + L4(4)
+constexpr uint32_t kPeekSize = 128;
+
+constexpr uint32_t kDltEn10Mb = 1;
+constexpr uint32_t kDltPpp = 9;
+constexpr uint32_t kDltIeee80211 = 105;
+
+struct PcapFileHeader
+{
+    uint32_t magic = 0xa1b2c3d4;
+    uint16_t versionMajor = 2;
+    uint16_t versionMinor = 4;
+    int32_t thiszone = 0;
+    uint32_t sigfigs = 0;
+    uint32_t snaplen = 0;
+    uint32_t network = 0;
+};
+
+struct PcapRecordHeader
+{
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+};
+
+uint16_t
+ReadU16(const uint8_t* p)
+{
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+/**
+ * 定位以太网类型字段之后的 IP 头。返回 IP 头偏移，非 IP 帧返回 -1。
+ */
+int32_t
+FindIpOffset(uint32_t dataLinkType, const uint8_t* buf, uint32_t len, uint16_t& etherType)
+{
+    if (dataLinkType == kDltPpp)
+    {
+        if (len < 2)
+            return -1;
+        uint16_t proto = ReadU16(buf);
+        etherType = proto == 0x0021 ? 0x0800 : (proto == 0x0057 ? 0x86dd : 0);
+        return 2;
+    }
+    if (dataLinkType == kDltEn10Mb)
+    {
+        if (len < 14)
+            return -1;
+        etherType = ReadU16(buf + 12);
+        if (etherType > 1500)
+            return 14;
+        // 802.3 长度字段，后接 LLC/SNAP
+        if (len < 22)
+            return -1;
+        etherType = ReadU16(buf + 20);
+        return 22;
+    }
+    if (dataLinkType == kDltIeee80211)
+    {
+        if (len < 24 || ((buf[0] >> 2) & 0x3) != 2)
+            return -1; // 非数据帧
+        uint32_t off = 24;
+        bool qos = buf[0] & 0x80;
+        bool amsdu = false;
+        if ((buf[1] & 0x03) == 0x03)
+            off += 6; // Addr4
+        if (qos)
+        {
+            if (len < off + 2)
+                return -1;
+            amsdu = buf[off] & 0x80;
+            off += 2;
+            if (buf[1] & 0x80)
+                off += 4; // HT Control
+        }
+        if (amsdu)
+            off += 14; // 只看第一个子帧
+        if (len < off + 8 || buf[off] != 0xaa || buf[off + 1] != 0xaa)
+            return -1;
+        etherType = ReadU16(buf + off + 6);
+        return off + 8;
+    }
+    return -1;
+}
+} // namespace
+
+AsyncPcapWriter::AsyncPcapWriter(const std::string& path,
+                                 uint32_t dataLinkType,
+                                 const PcapCaptureOptions& options)
+    : m_basePath(path),
+      m_dataLinkType(dataLinkType),
+      m_options(options),
+      m_writer(FileName(0), kPcapBufferSize)
+{
+    NS_ASSERT_MSG(m_options.sampleEvery >= 1, "pcap sampleEvery must be >= 1");
+    m_record.resize(std::max<std::size_t>(sizeof(PcapRecordHeader) + m_options.snaplen, kPeekSize));
+    WriteFileHeader();
+}
+
+std::string
+AsyncPcapWriter::FileName(uint64_t index) const
+{
+    if (m_options.maxFileSize == 0)
+        return m_basePath;
+
+    std::string stem = m_basePath;
+    const std::string ext = ".pcap";
+    if (stem.size() > ext.size() && stem.compare(stem.size() - ext.size(), ext.size(), ext) == 0)
+        stem.resize(stem.size() - ext.size());
+    if (m_options.maxFiles > 0)
+        index %= m_options.maxFiles;
+    return stem + "-" + std::to_string(index) + ext;
+}
+
+void
+AsyncPcapWriter::WriteFileHeader()
+{
+    PcapFileHeader header;
+    header.snaplen = m_options.snaplen;
+    header.network = m_dataLinkType;
+    m_writer.Write(&header, sizeof(header));
+}
+
+bool
+AsyncPcapWriter::Match(Ptr<const Packet> packet)
+{
+    if (m_options.protocol == 0 && m_options.port < 0)
+        return true;
+
+    // 只窥探头部字节，负载不拷贝
+    uint8_t* buf = m_record.data();
+    uint32_t len = packet->CopyData(buf, std::min(packet->GetSize(), kPeekSize));
+
+    uint16_t etherType = 0;
+    int32_t ip = FindIpOffset(m_dataLinkType, buf, len, etherType);
+    if (ip < 0)
+        return false;
+
+    uint8_t proto = 0;
+    uint32_t l4 = 0;
+    if (etherType == 0x0800 && len >= static_cast<uint32_t>(ip) + 20)
+    {
+        proto = buf[ip + 9];
+        l4 = ip + (buf[ip] & 0x0f) * 4;
+    }
+    else if (etherType == 0x86dd && len >= static_cast<uint32_t>(ip) + 40)
+    {
+        proto = buf[ip + 6]; // 不跟随扩展头
+        l4 = ip + 40;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (m_options.protocol != 0 && proto != m_options.protocol)
+        return false;
+    if (m_options.port < 0)
+        return true;
+    if ((proto != 6 && proto != 17) || len < l4 + 4)
+        return false;
+    const auto port = static_cast<uint16_t>(m_options.port);
+    return ReadU16(buf + l4) == port || ReadU16(buf + l4 + 2) == port;
+}
+
+void
+AsyncPcapWriter::Write(Time t, Ptr<const Packet> packet)
+{
+    if (!Match(packet))
+        return;
+    if (m_matched++ % m_options.sampleEvery != 0)
+        return;
+
+    const uint32_t origLen = packet->GetSize();
+    const uint32_t inclLen = std::min(origLen, m_options.snaplen);
+    const std::size_t recordLen = sizeof(PcapRecordHeader) + inclLen;
+
+    /* ---------- Rotation ---------- */
+    if (m_options.maxFileSize > 0 && m_writer.GetFileBytes() > sizeof(PcapFileHeader) &&
+        m_writer.GetFileBytes() + recordLen > m_options.maxFileSize)
+    {
+        m_writer.Reopen(FileName(++m_fileIndex));
+        WriteFileHeader();
+    }
+
+    const int64_t us = t.GetMicroSeconds();
+    PcapRecordHeader rec;
+    rec.tsSec = static_cast<uint32_t>(us / 1000000);
+    rec.tsUsec = static_cast<uint32_t>(us % 1000000);
+    rec.inclLen = inclLen;
+    rec.origLen = origLen;
+
+    // 只拷贝前 inclLen 字节，记录头与数据一次写入缓冲区
+    std::memcpy(m_record.data(), &rec, sizeof(rec));
+    packet->CopyData(m_record.data() + sizeof(rec), inclLen);
+    m_writer.Write(m_record.data(), recordLen);
+}
+
+void
+AsyncPcapWriter::Close()
+{
+    m_writer.Close();
+}
+} // namespace configjson2
+} // namespace ns3
@@ -0,0 +1,68 @@
+/**
+ * @file config-json2-pcap.h
+ * @brief Asynchronous, snaplen-truncating pcap writer.
+ */
+
+#ifndef CONFIG_JSON_PCAP_H
+#define CONFIG_JSON_PCAP_H
+
+#include "config-json2-async-writer.h"
+
+#include "ns3/network-module.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+// 单个抓包点的选项，对应 pcapLinkId 中的对象形式
+struct PcapCaptureOptions
+{
+    static constexpr uint32_t kDefaultSnaplen = 65535;
+
+    uint32_t snaplen = kDefaultSnaplen;
+    uint64_t maxFileSize = 0; // 单文件字节上限，0 表示不轮转
+    uint32_t maxFiles = 0;    // 轮转文件环的大小，0 表示编号一直递增
+    uint32_t sampleEvery = 1; // 1-in-N 采样（在过滤之后计数）
+    uint8_t protocol = 0;     // IP 协议号过滤，0 表示不过滤
+    int32_t port = -1;        // 源或目的端口过滤，-1 表示不过滤
+};
+
+/**
+ * 替代 PcapFileWrapper 的抓包后端。
+ *
+ * 每个包依次经过：协议/端口过滤（只窥探链路层+IP+L4 头部）、1-in-N 采样、
+ * 文件大小检查（必要时轮转），通过后才拷贝前 snaplen 字节到本文件的缓冲区，
+ * 由 AsyncFileWriter 的 I/O 线程写盘；记录头中 orig_len 保留原始长度。
+ *
+ * 开启轮转时文件名为 <base>-<k>.pcap，maxFiles > 0 时 k 对其取模，覆盖最旧的文件。
+ */
+class AsyncPcapWriter : public SimpleRefCount<AsyncPcapWriter>
+{
+  public:
+    AsyncPcapWriter(const std::string& path,
+                    uint32_t dataLinkType,
+                    const PcapCaptureOptions& options);
+
+    void Write(Time t, Ptr<const Packet> packet);
+    void Close();
+
+  private:
+    bool Match(Ptr<const Packet> packet);
+    std::string FileName(uint64_t index) const;
+    void WriteFileHeader();
+
+    std::string m_basePath;
+    uint32_t m_dataLinkType;
+    PcapCaptureOptions m_options;
+    uint64_t m_matched = 0;
+    uint64_t m_fileIndex = 0;
+    std::vector<uint8_t> m_record;
+    AsyncFileWriter m_writer;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_PCAP_H
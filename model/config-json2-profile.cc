@@ -0,0 +1,373 @@
+#include "config-json2-profile.h"
+
+#include "config-json2-culling.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace ns3
+{
+namespace configjson2
+{
+WifiStandard
+ParseWifiStandard(const std::string& s)
+{
+    static const std::unordered_map<std::string, WifiStandard> table = {
+        {"WIFI_STANDARD_80211a", WIFI_STANDARD_80211a},
+        {"WIFI_STANDARD_80211b", WIFI_STANDARD_80211b},
+        {"WIFI_STANDARD_80211g", WIFI_STANDARD_80211g},
+        {"WIFI_STANDARD_80211n", WIFI_STANDARD_80211n},
+        {"WIFI_STANDARD_80211ac", WIFI_STANDARD_80211ac},
+        {"WIFI_STANDARD_80211ax", WIFI_STANDARD_80211ax},
+        {"WIFI_STANDARD_80211be", WIFI_STANDARD_80211be},
+    };
+
+    auto it = table.find(s);
+    if (it == table.end())
+    {
+        throw std::invalid_argument("Unknown WifiStandard: " + s);
+    }
+    return it->second;
+}
+
+void
+ConfigureP2p(PointToPointHelper& p2p, const json& j)
+{
+    /* ===============================
+     * Queue (optional)
+     * =============================== */
+    if (j.contains("queue"))
+    {
+        const auto& jQueue = j.at("queue");
+        for (auto it = jQueue.begin(); it != jQueue.end(); ++it)
+        {
+            const std::string& key = it.key();
+            const auto& val = it.value();
+
+            if (key == "type")
+            {
+                p2p.SetQueue(val.get<std::string>());
+            }
+        }
+    }
+
+    /* ===============================
+     * Channel attributes (optional)
+     * =============================== */
+    if (j.contains("channel"))
+    {
+        const auto& jChannel = j.at("channel");
+        for (auto it = jChannel.begin(); it != jChannel.end(); ++it)
+        {
+            const std::string& key = it.key();
+            const auto& val = it.value();
+
+            if (key == "type")
+                continue;
+
+            if (key == "delay")
+            {
+                p2p.SetChannelAttribute("Delay", TimeValue(Time(val.get<std::string>())));
+            }
+        }
+    }
+
+    /* ===============================
+     * Device attributes (optional)
+     * =============================== */
+    if (j.contains("device"))
+    {
+        const auto& jDevice = j.at("device");
+        for (auto it = jDevice.begin(); it != jDevice.end(); ++it)
+        {
+            const std::string& key = it.key();
+            const auto& val = it.value();
+
+            if (key == "type")
+                continue;
+
+            if (key == "dataRate")
+            {
+                p2p.SetDeviceAttribute("DataRate", DataRateValue(DataRate(val.get<std::string>())));
+            }
+            else if (key == "mtu")
+            {
+                p2p.SetDeviceAttribute("Mtu", UintegerValue(val.get<uint32_t>()));
+            }
+        }
+    }
+}
+
+void
+ConfigureWifiPhy(WifiPhyHelper& phy, const json& jPhy)
+{
+    for (auto it = jPhy.begin(); it != jPhy.end(); ++it)
+    {
+        const std::string& k = it.key();
+        const auto& v = it.value();
+        if (k == "type")
+            continue;
+
+        if (k == "channelSettings")
+            phy.Set("ChannelSettings", StringValue(v.get<std::string>()));
+        else if (k == "txPowerStart")
+            phy.Set("TxPowerStart", DoubleValue(v.get<double>()));
+        else if (k == "txPowerEnd")
+            phy.Set("TxPowerEnd", DoubleValue(v.get<double>()));
+        else if (k == "rxSensitivity")
+            phy.Set("RxSensitivity", DoubleValue(v.get<double>()));
+        else if (k == "ccaEdThreshold")
+            phy.Set("CcaEdThreshold", DoubleValue(v.get<double>()));
+    }
+}
+
+void
+ConfigureWifiMac(WifiMacHelper& mac, const json& jMac)
+{
+    mac.SetType(jMac.at("type").get<std::string>(),
+                "Ssid",
+                SsidValue(Ssid(jMac.at("ssid").get<std::string>())));
+}
+
+WifiProfile
+DecodeWifiProfile(const json& j)
+{
+    WifiProfile profile;
+
+    /* ---------- WifiHelper ---------- */
+    profile.wifi.SetStandard(ParseWifiStandard(j.at("wifiStandard").get<std::string>()));
+
+    const auto& wm = j.at("wifiManager");
+    profile.wifi.SetRemoteStationManager(wm.at("type").get<std::string>(),
+                                         "DataMode",
+                                         StringValue(wm.at("dataMode").get<std::string>()),
+                                         "ControlMode",
+                                         StringValue(wm.at("controlMode").get<std::string>()));
+
+    /* ---------- Channel ---------- */
+    const auto& jChannel = j.at("channel");
+    profile.channelType = jChannel.at("type").get<std::string>();
+    if (profile.channelType != "ns3::YansWifiChannel" &&
+        profile.channelType != "ns3::SingleModelSpectrumChannel" &&
+        profile.channelType != "ns3::MultiModelSpectrumChannel")
+    {
+        NS_FATAL_ERROR("Unsupported Wifi channel type: " << profile.channelType);
+    }
+    profile.propagationDelay = jChannel.at("propagationDelay").get<std::string>();
+    for (const auto& loss : jChannel.at("propagationLoss"))
+        profile.propagationLoss.push_back(loss.at("type").get<std::string>());
+    if (jChannel.contains("culling"))
+    {
+        // Yans 信道没有发送过滤接口，截断距离只会改变结果而不减少接收事件
+        if (profile.channelType == "ns3::YansWifiChannel")
+            throw std::invalid_argument("channel.culling requires a spectrum channel "
+                                        "(ns3::SingleModelSpectrumChannel or "
+                                        "ns3::MultiModelSpectrumChannel), not "
+                                        "ns3::YansWifiChannel");
+        const auto& jCulling = jChannel.at("culling");
+        WifiCulling culling;
+        culling.maxRange = jCulling.at("maxRange").get<double>();
+        if (jCulling.contains("minRxPower"))
+            culling.minRxPower = jCulling.at("minRxPower").get<double>();
+        if (jCulling.contains("refresh"))
+            culling.refresh = Time(jCulling.at("refresh").get<std::string>());
+        culling.margin = jCulling.value("margin", 0.0);
+        if (culling.maxRange <= 0)
+            throw std::invalid_argument("channel.culling.maxRange must be positive");
+        profile.culling = culling;
+    }
+
+    /* ---------- PHY / MAC defaults ---------- */
+    const std::string errorRateModel = j.at("errorRateModel").get<std::string>();
+    profile.yansPhy.SetErrorRateModel(errorRateModel);
+    profile.spectrumPhy.SetErrorRateModel(errorRateModel);
+    if (j.contains("wifiPhy"))
+    {
+        ConfigureWifiPhy(profile.yansPhy, j.at("wifiPhy"));
+        ConfigureWifiPhy(profile.spectrumPhy, j.at("wifiPhy"));
+    }
+    if (j.contains("wifiMac"))
+    {
+        profile.hasMac = true;
+        ConfigureWifiMac(profile.mac, j.at("wifiMac"));
+    }
+    return profile;
+}
+
+Ptr<Channel>
+CreateWifiChannel(const WifiProfile& profile)
+{
+    Ptr<Channel> channel;
+
+    if (profile.channelType == "ns3::YansWifiChannel")
+    {
+        YansWifiChannelHelper ch;
+        ch.SetPropagationDelay(profile.propagationDelay);
+
+        Ptr<PropagationLossModel> first = nullptr;
+        Ptr<PropagationLossModel> prev = nullptr;
+
+        for (const auto& type : profile.propagationLoss)
+        {
+            Ptr<PropagationLossModel> cur;
+
+            if (type == "ns3::FriisPropagationLossModel")
+                cur = CreateObject<FriisPropagationLossModel>();
+            else if (type == "ns3::LogDistancePropagationLossModel")
+                cur = CreateObject<LogDistancePropagationLossModel>();
+            else if (type == "ns3::NakagamiPropagationLossModel")
+                cur = CreateObject<NakagamiPropagationLossModel>();
+            else
+                NS_FATAL_ERROR("Unsupported PropagationLossModel: " << type);
+
+            if (!first)
+                first = cur;
+            if (prev)
+                prev->SetNext(cur);
+            prev = cur;
+        }
+
+        channel = ch.Create();
+        DynamicCast<YansWifiChannel>(channel)->SetPropagationLossModel(first);
+    }
+    else
+    {
+        SpectrumChannelHelper ch;
+        ch.SetChannel(profile.channelType);
+        ch.SetPropagationDelay(profile.propagationDelay);
+
+        Ptr<PropagationLossModel> first = nullptr;
+        for (const auto& type : profile.propagationLoss)
+        {
+            Ptr<PropagationLossModel> m;
+
+            if (type == "ns3::FriisPropagationLossModel")
+                m = CreateObject<FriisPropagationLossModel>();
+            else if (type == "ns3::LogDistancePropagationLossModel")
+                m = CreateObject<LogDistancePropagationLossModel>();
+            else
+                NS_FATAL_ERROR("Unsupported PropagationLossModel: " << type);
+
+            if (!first)
+                first = m;
+            ch.AddPropagationLoss(m);
+        }
+
+        channel = ch.Create();
+        if (profile.culling)
+        {
+            Ptr<SpectrumChannel> spectrum = DynamicCast<SpectrumChannel>(channel);
+            Ptr<GridTransmitFilter> filter = CreateObject<GridTransmitFilter>();
+            filter->SetAttribute("MaxRange", DoubleValue(profile.culling->maxRange));
+            filter->SetAttribute("RefreshInterval", TimeValue(profile.culling->refresh));
+            filter->SetAttribute("Margin", DoubleValue(profile.culling->margin));
+            if (profile.culling->minRxPower)
+            {
+                filter->SetAttribute("MinRxPower", DoubleValue(*profile.culling->minRxPower));
+                filter->SetPropagationLoss(first);
+            }
+            filter->SetChannel(PeekPointer(spectrum));
+            spectrum->AddSpectrumTransmitFilter(filter);
+        }
+    }
+    return channel;
+}
+
+OnOffHelper
+DecodeOnOffProfile(const json& j)
+{
+    OnOffHelper onoff(j.value("protocol", "ns3::UdpSocketFactory"), Address());
+
+    for (auto it = j.begin(); it != j.end(); ++it)
+    {
+        const std::string& key = it.key();
+        const auto& val = it.value();
+
+        if (key == "dataRate")
+            onoff.SetAttribute("DataRate", DataRateValue(DataRate(val.get<std::string>())));
+        else if (key == "packetSize")
+            onoff.SetAttribute("PacketSize", UintegerValue(val.get<uint32_t>()));
+        else if (key == "onTime")
+            onoff.SetAttribute("OnTime", StringValue(val.get<std::string>()));
+        else if (key == "offTime")
+            onoff.SetAttribute("OffTime", StringValue(val.get<std::string>()));
+    }
+    return onoff;
+}
+
+std::shared_ptr<ProfileSet>
+ProfileSet::Decode(const json& jProfiles)
+{
+    auto set = std::make_shared<ProfileSet>();
+
+    if (jProfiles.contains("link"))
+    {
+        for (const auto& [name, jProfile] : jProfiles.at("link").items())
+        {
+            const std::string type = jProfile.at("type").get<std::string>();
+            if (type == "p2p")
+            {
+                PointToPointHelper p2p;
+                ConfigureP2p(p2p, jProfile);
+                set->m_p2p.emplace(name, p2p);
+            }
+            else if (type == "wifi")
+                set->m_wifi.emplace(name, DecodeWifiProfile(jProfile));
+            else
+                throw std::invalid_argument("Unsupported link profile type: " + type);
+        }
+    }
+
+    if (jProfiles.contains("application"))
+    {
+        for (const auto& [name, jProfile] : jProfiles.at("application").items())
+        {
+            const std::string type = jProfile.at("type").get<std::string>();
+            if (type == "OnOff")
+                set->m_onoff.emplace(name, DecodeOnOffProfile(jProfile));
+            else
+                throw std::invalid_argument("Unsupported application profile type: " + type);
+        }
+    }
+    return set;
+}
+
+namespace
+{
+template <typename T>
+const T&
+FindProfile(const std::map<std::string, T>& profiles, const std::string& name, const char* kind)
+{
+    auto it = profiles.find(name);
+    if (it == profiles.end())
+        throw std::invalid_argument(std::string("Unknown ") + kind + " profile: " + name);
+    return it->second;
+}
+} // namespace
+
+const PointToPointHelper&
+ProfileSet::FindP2p(const std::string& name) const
+{
+    return FindProfile(m_p2p, name, "p2p");
+}
+
+const WifiProfile&
+ProfileSet::FindWifi(const std::string& name) const
+{
+    return FindProfile(m_wifi, name, "wifi");
+}
+
+const OnOffHelper&
+ProfileSet::FindOnOff(const std::string& name) const
+{
+    return FindProfile(m_onoff, name, "OnOff");
+}
+
+const ProfileSet&
+GetProfiles(const ConfigJsonHelper& helper)
+{
+    static const ProfileSet empty;
+    return helper.profiles ? *helper.profiles : empty;
+}
+} // namespace configjson2
+} // namespace ns3
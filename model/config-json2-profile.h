@@ -0,0 +1,98 @@
+/**
+ * @file config-json2-profile.h
+ * @brief Named link / application profiles decoded once into configured ns-3 helpers.
+ */
+
+#ifndef CONFIG_JSON_PROFILE_H
+#define CONFIG_JSON_PROFILE_H
+
+#include "../helper/config-json2-helper.h"
+
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/wifi-module.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+WifiStandard ParseWifiStandard(const std::string& s);
+
+// channel.culling：剔除远处接收者，见 GridTransmitFilter
+struct WifiCulling
+{
+    double maxRange = 0;              // m
+    std::optional<double> minRxPower; // dBm，仅 spectrum 信道
+    Time refresh = Seconds(1);        // 位置索引的最长使用时间
+    double margin = 0;                // m，覆盖两次重建之间的移动
+};
+
+// 一条 wifi 链路除各设备之外的设置；信道及其损耗模型每条链路各建一份，不在链路间共享
+struct WifiProfile
+{
+    WifiHelper wifi;
+    std::string channelType;
+    std::string propagationDelay;
+    std::vector<std::string> propagationLoss;
+    std::optional<WifiCulling> culling;
+    // 已设置 ErrorRateModel 和 wifiPhy 默认属性，按 channelType 使用其中一个
+    YansWifiPhyHelper yansPhy;
+    SpectrumWifiPhyHelper spectrumPhy;
+    // 设备未写 wifiMac 时使用
+    bool hasMac = false;
+    WifiMacHelper mac;
+};
+
+// 按 queue / channel / device 块设置 p2p，链路元素和 p2p profile 共用
+void ConfigureP2p(PointToPointHelper& p2p, const json& j);
+// 读取 wifiStandard / wifiManager / channel / errorRateModel 及可选的 wifiPhy / wifiMac
+WifiProfile DecodeWifiProfile(const json& j);
+// 把 wifiPhy 块中的属性设置到 phy
+void ConfigureWifiPhy(WifiPhyHelper& phy, const json& jPhy);
+// 按 wifiMac 块设置 MAC 类型和 SSID
+void ConfigureWifiMac(WifiMacHelper& mac, const json& jMac);
+// 为一条链路新建信道；设置了 culling 时附加接收者剔除
+Ptr<Channel> CreateWifiChannel(const WifiProfile& profile);
+// 读取 protocol / dataRate / packetSize / onTime / offTime，Remote 由各应用设置
+OnOffHelper DecodeOnOffProfile(const json& j);
+
+/**
+ * config.json 中 "profiles" 的解码结果：
+ *
+ * "profiles": {
+ *     "link":        { "<name>": { "type": "p2p" | "wifi", ... } },
+ *     "application": { "<name>": { "type": "OnOff", ... } }
+ * }
+ *
+ * 每个 profile 在 Load 时解码一次成配置好的 helper，引用它的元素只复制 helper，
+ * 不再逐个解析同样的属性块；元素中同名的块在 profile 之后应用，可覆盖个别属性。
+ */
+class ProfileSet
+{
+  public:
+    static std::shared_ptr<ProfileSet> Decode(const json& jProfiles);
+
+    // 名字不存在或类型不符时抛出 invalid_argument
+    const PointToPointHelper& FindP2p(const std::string& name) const;
+    const WifiProfile& FindWifi(const std::string& name) const;
+    const OnOffHelper& FindOnOff(const std::string& name) const;
+
+  private:
+    std::map<std::string, PointToPointHelper> m_p2p;
+    std::map<std::string, WifiProfile> m_wifi;
+    std::map<std::string, OnOffHelper> m_onoff;
+};
+
+// helper 未加载 profiles 时返回空集合
+const ProfileSet& GetProfiles(const ConfigJsonHelper& helper);
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_PROFILE_H
@@ -0,0 +1,228 @@
+#include "config-json2-telemetry.h"
+
+#include "../helper/config-json2-profiler.h"
+
+#include <cstdio>
+
+namespace ns3
+{
+namespace configjson2
+{
+namespace
+{
+// 单写者计数：仿真线程独占写，避免原子 RMW 指令
+inline void
+Bump(std::atomic<uint64_t>& counter, int64_t delta)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+} // namespace
+
+/* ===============================
+ * CountingScheduler
+ * =============================== */
+NS_OBJECT_ENSURE_REGISTERED(CountingScheduler);
+
+TypeId
+CountingScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::configjson2::CountingScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("ConfigJson2")
+            .AddConstructor<CountingScheduler>()
+            .AddAttribute("Inner",
+                          "Scheduler that actually stores the events.",
+                          TypeIdValue(MapScheduler::GetTypeId()),
+                          MakeTypeIdAccessor(&CountingScheduler::SetInner,
+                                             &CountingScheduler::GetInner),
+                          MakeTypeIdChecker());
+    return tid;
+}
+
+CountingScheduler::Counters&
+CountingScheduler::GetCounters()
+{
+    static Counters counters;
+    return counters;
+}
+
+CountingScheduler::CountingScheduler()
+{
+}
+
+CountingScheduler::~CountingScheduler()
+{
+}
+
+void
+CountingScheduler::SetInner(const TypeId& tid)
+{
+    NS_ASSERT_MSG(!m_inner || m_inner->IsEmpty(), "Cannot replace a non-empty scheduler");
+    ObjectFactory factory;
+    factory.SetTypeId(tid);
+    m_inner = factory.Create<Scheduler>();
+}
+
+TypeId
+CountingScheduler::GetInner() const
+{
+    return m_inner ? m_inner->GetInstanceTypeId() : MapScheduler::GetTypeId();
+}
+
+void
+CountingScheduler::Insert(const Event& ev)
+{
+    m_inner->Insert(ev);
+    Bump(GetCounters().size, 1);
+}
+
+bool
+CountingScheduler::IsEmpty() const
+{
+    return m_inner->IsEmpty();
+}
+
+Scheduler::Event
+CountingScheduler::PeekNext() const
+{
+    return m_inner->PeekNext();
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext()
+{
+    Event ev = m_inner->RemoveNext();
+    Counters& c = GetCounters();
+    Bump(c.size, -1);
+    Bump(c.executed, 1);
+    c.nowTs.store(ev.key.m_ts, std::memory_order_relaxed);
+    if (c.executed.load(std::memory_order_relaxed) == c.stopAt.load(std::memory_order_relaxed))
+        Simulator::Stop();
+    return ev;
+}
+
+void
+CountingScheduler::Remove(const Event& ev)
+{
+    m_inner->Remove(ev);
+    Bump(GetCounters().size, -1);
+}
+
+/* ===============================
+ * SimulatorTelemetry
+ * =============================== */
+SimulatorTelemetry::SimulatorTelemetry(const std::string& path,
+                                       std::chrono::milliseconds interval,
+                                       Time stopTime)
+    : m_writer(path, 64u << 10),
+      m_interval(interval),
+      m_stopSec(stopTime.GetSeconds())
+{
+    m_writer.Write("wallSec,simSec,events,eventsPerSec,simWallRatio,queueSize,rssBytes,etaSec\n");
+}
+
+SimulatorTelemetry::~SimulatorTelemetry()
+{
+    Stop();
+}
+
+void
+SimulatorTelemetry::InstallCountingScheduler()
+{
+    TypeIdValue inner;
+    GlobalValue::GetValueByName("SchedulerType", inner);
+    if (inner.Get() == CountingScheduler::GetTypeId())
+        return;
+
+    ObjectFactory factory;
+    factory.SetTypeId(CountingScheduler::GetTypeId());
+    factory.Set("Inner", inner);
+    // 搬移事件时旧调度器（可能也是 CountingScheduler）的 RemoveNext 不应计为已执行
+    std::atomic<uint64_t>& executed = CountingScheduler::GetCounters().executed;
+    const uint64_t before = executed.load(std::memory_order_relaxed);
+    Simulator::SetScheduler(factory);
+    executed.store(before, std::memory_order_relaxed);
+}
+
+void
+SimulatorTelemetry::Start()
+{
+    if (m_thread.joinable())
+        return;
+
+    m_start = std::chrono::steady_clock::now();
+    m_lastWall = m_start;
+    m_lastEvents = CountingScheduler::GetCounters().executed.load(std::memory_order_relaxed);
+    m_thread = std::thread(&SimulatorTelemetry::Run, this);
+}
+
+void
+SimulatorTelemetry::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+
+    // 最后一行反映仿真结束时的状态
+    Probe();
+    m_writer.Close();
+}
+
+void
+SimulatorTelemetry::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_cv.wait_for(lock, m_interval, [this]() { return m_stop; }))
+    {
+        lock.unlock();
+        Probe();
+        // 每行都移交给 I/O 线程，tail -f 能及时看到
+        m_writer.Flush();
+        lock.lock();
+    }
+}
+
+void
+SimulatorTelemetry::Probe()
+{
+    const CountingScheduler::Counters& c = CountingScheduler::GetCounters();
+    const uint64_t events = c.executed.load(std::memory_order_relaxed);
+    const uint64_t queue = c.size.load(std::memory_order_relaxed);
+    const double simSec = TimeStep(c.nowTs.load(std::memory_order_relaxed)).GetSeconds();
+
+    const auto now = std::chrono::steady_clock::now();
+    const double wallSec = std::chrono::duration<double>(now - m_start).count();
+    const double dWall = std::chrono::duration<double>(now - m_lastWall).count();
+
+    // 速率取最近一个采样区间，ETA 按该区间的仿真推进速度外推
+    const double rate = dWall > 0 ? (events - m_lastEvents) / dWall : 0;
+    const double ratio = dWall > 0 ? (simSec - m_lastSimSec) / dWall : 0;
+    const double eta = ratio > 0 ? (m_stopSec - simSec) / ratio : -1;
+
+    char line[256];
+    int n = std::snprintf(line,
+                          sizeof(line),
+                          "%.3f,%.9f,%llu,%.1f,%.6g,%llu,%lld,%.1f\n",
+                          wallSec,
+                          simSec,
+                          static_cast<unsigned long long>(events),
+                          rate,
+                          ratio,
+                          static_cast<unsigned long long>(queue),
+                          static_cast<long long>(InstallProfiler::ResidentBytes()),
+                          eta);
+    m_writer.Write(line, n);
+
+    m_lastWall = now;
+    m_lastEvents = events;
+    m_lastSimSec = simSec;
+}
+} // namespace configjson2
+} // namespace ns3
@@ -0,0 +1,102 @@
+/**
+ * @file config-json2-telemetry.h
+ * @brief Wall-clock runtime telemetry for a running simulation.
+ */
+
+#ifndef CONFIG_JSON_TELEMETRY_H
+#define CONFIG_JSON_TELEMETRY_H
+
+#include "config-json2-async-writer.h"
+
+#include "ns3/core-module.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * 转发到内层调度器的 Scheduler，同时维护事件计数。
+ *
+ * 计数器只由仿真线程写（relaxed load + store，无锁前缀），
+ * 遥测线程随时读取，不需要进入仿真线程。
+ */
+class CountingScheduler : public Scheduler
+{
+  public:
+    struct Counters
+    {
+        std::atomic<uint64_t> executed{0}; // RemoveNext 次数（含已取消的事件）
+        std::atomic<uint64_t> size{0};     // 当前事件队列长度
+        std::atomic<uint64_t> nowTs{0};    // 最近一次出队事件的时间戳（TimeStep）
+        // executed 到达该值时 Simulator::Stop()，调度器预热用它让每个候选执行同样多的事件
+        std::atomic<uint64_t> stopAt{UINT64_MAX};
+    };
+
+    static TypeId GetTypeId();
+    static Counters& GetCounters();
+
+    CountingScheduler();
+    ~CountingScheduler() override;
+
+    void Insert(const Event& ev) override;
+    bool IsEmpty() const override;
+    Event PeekNext() const override;
+    Event RemoveNext() override;
+    void Remove(const Event& ev) override;
+
+  private:
+    void SetInner(const TypeId& tid);
+    TypeId GetInner() const;
+
+    Ptr<Scheduler> m_inner;
+};
+
+/**
+ * 仿真运行状态探针。
+ *
+ * 后台线程按墙钟间隔采样 CountingScheduler 的计数器，每行记录
+ * 事件总数、事件速率、仿真/墙钟时间比、队列长度、RSS 和预计剩余时间。
+ * 按墙钟而不是仿真时间采样：仿真卡住（仿真时间不前进）时仍然持续输出，
+ * 可以区分“慢”和“挂起”。
+ */
+class SimulatorTelemetry
+{
+  public:
+    SimulatorTelemetry(const std::string& path, std::chrono::milliseconds interval, Time stopTime);
+    ~SimulatorTelemetry();
+
+    // 将当前调度器替换为 CountingScheduler（内层类型取 SchedulerType 全局值）
+    static void InstallCountingScheduler();
+
+    // 仿真开始时启动采样线程，Simulator::Destroy() 时停止
+    void Start();
+    void Stop();
+
+  private:
+    void Run();
+    void Probe();
+
+    AsyncFileWriter m_writer;
+    std::chrono::milliseconds m_interval;
+    double m_stopSec;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_lastWall;
+    uint64_t m_lastEvents = 0;
+    double m_lastSimSec = 0;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_TELEMETRY_H
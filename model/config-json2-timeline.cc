@@ -0,0 +1,80 @@
+#include "config-json2-timeline.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+namespace configjson2
+{
+NS_LOG_COMPONENT_DEFINE("ConfigJson2Timeline");
+
+void
+AttributeTimeline::Add(Time at,
+                       Ptr<Object> object,
+                       Ptr<const AttributeAccessor> accessor,
+                       Ptr<const AttributeValue> value)
+{
+    m_changes.push_back({at, object, accessor, value});
+}
+
+void
+AttributeTimeline::Start()
+{
+    std::stable_sort(m_changes.begin(), m_changes.end(), [](const Change& a, const Change& b) {
+        return a.at < b.at;
+    });
+    m_next = 0;
+    ScheduleNext();
+}
+
+std::size_t
+AttributeTimeline::GetNChanges() const
+{
+    return m_changes.size();
+}
+
+std::size_t
+AttributeTimeline::GetNBatches() const
+{
+    std::size_t batches = 0;
+    for (std::size_t i = 0; i < m_changes.size(); ++i)
+    {
+        if (i == 0 || m_changes[i].at != m_changes[i - 1].at)
+            ++batches;
+    }
+    return batches;
+}
+
+void
+AttributeTimeline::ScheduleNext()
+{
+    if (m_next >= m_changes.size())
+    {
+        // 全部执行完后释放对象引用
+        m_changes.clear();
+        m_changes.shrink_to_fit();
+        return;
+    }
+    // 早于当前时刻的修改立即执行
+    const Time delay = std::max(m_changes[m_next].at - Simulator::Now(), Time(0));
+    Simulator::Schedule(delay, &AttributeTimeline::Run, Ptr<AttributeTimeline>(this));
+}
+
+void
+AttributeTimeline::Run()
+{
+    const Time at = m_changes[m_next].at;
+    std::size_t applied = 0;
+    for (; m_next < m_changes.size() && m_changes[m_next].at == at; ++m_next)
+    {
+        const Change& change = m_changes[m_next];
+        if (!change.accessor->Set(PeekPointer(change.object), *change.value))
+            NS_LOG_WARN("timeline: failed to set attribute on "
+                        << change.object->GetInstanceTypeId().GetName() << " at " << at);
+        ++applied;
+    }
+    NS_LOG_DEBUG("timeline: applied " << applied << " changes at " << at);
+    ScheduleNext();
+}
+} // namespace configjson2
+} // namespace ns3
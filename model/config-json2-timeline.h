@@ -0,0 +1,59 @@
+/**
+ * @file config-json2-timeline.h
+ * @brief Attribute changes scheduled during the run, batched by timestamp.
+ */
+
+#ifndef CONFIG_JSON_TIMELINE_H
+#define CONFIG_JSON_TIMELINE_H
+
+#include "ns3/core-module.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3
+{
+namespace configjson2
+{
+/**
+ * 仿真过程中的属性修改序列。
+ *
+ * 每条修改在安装时已解析为对象指针、属性访问器和校验过的属性值，运行时只调用
+ * accessor->Set，不再查找路径、解析字符串。按时间排序后同一时刻的修改合成一个事件，
+ * 调度器中任何时候只挂着下一批的一个事件，数万条修改也不会撑大事件队列。
+ */
+class AttributeTimeline : public SimpleRefCount<AttributeTimeline>
+{
+  public:
+    void Add(Time at,
+             Ptr<Object> object,
+             Ptr<const AttributeAccessor> accessor,
+             Ptr<const AttributeValue> value);
+
+    // 按时间稳定排序（同一时刻保持文件中的顺序）并调度第一批，须在 Simulator::Run 之前调用
+    void Start();
+
+    std::size_t GetNChanges() const;
+    // 不同时刻的个数，即调度的事件数
+    std::size_t GetNBatches() const;
+
+  private:
+    struct Change
+    {
+        Time at;
+        Ptr<Object> object;
+        Ptr<const AttributeAccessor> accessor;
+        Ptr<const AttributeValue> value;
+    };
+
+    void ScheduleNext();
+    // 执行当前时刻的一批修改，再调度下一批
+    void Run();
+
+    std::vector<Change> m_changes;
+    std::size_t m_next = 0;
+};
+} // namespace configjson2
+} // namespace ns3
+
+#endif // CONFIG_JSON_TIMELINE_H